@@ -0,0 +1,12 @@
+/**
+ * @file startup-baseline.cpp
+ * @brief Baseline for startup-harness, a program that exits without linking the parser.
+ * @date 2026-10-18
+ */
+
+#include <cstdlib>
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file startup-harness.cpp
+ * @brief Startup latency of programs built on the parser.
+ * @date 2026-10-18
+ *
+ * The harness spawns the probe and the baseline program repeatedly and measures the time from
+ * spawn to exit of each. The baseline is a separate executable that does not link the parser,
+ * so the difference of both includes loading the library, its static initialization and parsing.
+ *
+ * Usage: startup-harness [-n RUNS] -b BASELINE -- PROBE [ARGS...]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "arg_parser.hpp"
+
+extern char** environ;
+
+namespace {
+
+/**
+ * @brief Time from spawn to exit of the program in microseconds, negative if the program failed.
+ */
+double run(char* const* argv)
+{
+    pid_t pid;
+    int status = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (posix_spawn(&pid, argv[0], nullptr, nullptr, argv, environ) != 0
+        || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        return -1.0;
+    }
+
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+double percentile(std::vector<double>& times, double p)
+{
+    const auto idx = static_cast<std::size_t>(p * static_cast<double>(times.size() - 1));
+
+    std::nth_element(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(idx), times.end());
+    return times[idx];
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    ArgumentParser args("Startup latency of a program built on the parser.", "[-n RUNS] -b BASELINE -- PROBE [ARGS...]");
+
+    const auto runs_opt = args.register_option({"n", "runs"}, ArgumentOption::OPTIONAL, ArgumentType::INT,
+                                               "Number of runs", "", arg_default("2000"));
+    const auto baseline_opt = args.register_option({"b", "baseline"}, ArgumentOption::REQUIRED, ArgumentType::STR,
+                                                   "Baseline program not linked against the parser");
+    args.set_pass_through(true);
+
+    try {
+        args.load_arguments(argc, argv);
+    } catch (std::logic_error& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        return EXIT_FAILURE;
+    }
+
+    if (args.option_is_set("help") || !args.forward_argv()) {
+        args.print_help_text();
+        return args.option_is_set("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const auto runs = args.parse_option<int>(runs_opt);
+    const auto probe = args.forward_argv();
+    auto baseline_path = args[baseline_opt];
+    char* const baseline[] = {&baseline_path[0], nullptr};
+
+    std::vector<double> probe_times;
+    std::vector<double> baseline_times;
+
+    // runs are interleaved so both series see the same system state
+    for (auto R = 0; R < runs; R++) {
+        const auto b = run(baseline);
+        const auto p = run(probe);
+
+        if (b < 0 || p < 0) {
+            std::fprintf(stderr, "Program %s failed.\n", b < 0 ? baseline[0] : probe[0]);
+            return EXIT_FAILURE;
+        }
+
+        baseline_times.push_back(b);
+        probe_times.push_back(p);
+    }
+
+    const auto b50 = percentile(baseline_times, 0.5);
+    const auto b99 = percentile(baseline_times, 0.99);
+    const auto p50 = percentile(probe_times, 0.5);
+    const auto p99 = percentile(probe_times, 0.99);
+
+    std::printf("runs:     %d\n", runs);
+    std::printf("baseline: p50 %8.1f us  p99 %8.1f us\n", b50, b99);
+    std::printf("probe:    p50 %8.1f us  p99 %8.1f us\n", p50, p99);
+    std::printf("parser:   p50 %8.1f us\n", p50 - b50);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file startup-probe.cpp
+ * @brief Short-lived program measured by startup-harness.
+ * @date 2026-10-18
+ */
+
+#include <cstdlib>
+
+#include "arg_parser.hpp"
+
+namespace {
+
+// constant initialized, nothing runs before main
+constexpr arg_spec options[] = {
+    {"v", "verbose", ArgumentOption::OPTIONAL, ArgumentType::BOOL, "Verbose output", "", nullptr},
+    {"q", "quiet", ArgumentOption::OPTIONAL, ArgumentType::BOOL, "No output", "", nullptr},
+    {"t", "threads", ArgumentOption::OPTIONAL, ArgumentType::INT, "Number of threads", "", "1"},
+    {"", "name", ArgumentOption::OPTIONAL, ArgumentType::STR, "Job name", "", nullptr},
+    {"", "ratio", ArgumentOption::OPTIONAL, ArgumentType::FLT, "Sampling ratio", "", "0.5"},
+    {"", "mask", ArgumentOption::OPTIONAL, ArgumentType::HEX, "CPU mask", "", "ff"},
+    {"o", "output", ArgumentOption::OPTIONAL, ArgumentType::STR, "Output file", "", nullptr},
+    {"i", "input", ArgumentOption::OPTIONAL, ArgumentType::FILE, "Input file", "", nullptr},
+    {"", "retries", ArgumentOption::OPTIONAL, ArgumentType::INT, "Number of retries", "", "3"},
+    {"", "timeout", ArgumentOption::OPTIONAL, ArgumentType::FLT, "Timeout in seconds", "", "30"},
+    {"", "log-level", ArgumentOption::OPTIONAL, ArgumentType::INT, "Logging level", "", "2"},
+    {"", "log-file", ArgumentOption::OPTIONAL, ArgumentType::STR, "Log file", "", nullptr},
+    {"", "dry-run", ArgumentOption::OPTIONAL, ArgumentType::BOOL, "Do not change anything", "", nullptr},
+    {"", "batch-size", ArgumentOption::OPTIONAL, ArgumentType::INT, "Batch size", "", "64"},
+    {"", "queue", ArgumentOption::OPTIONAL, ArgumentType::STR, "Queue name", "", "default"},
+    {"", "priority", ArgumentOption::OPTIONAL, ArgumentType::INT, "Job priority", "", "0"},
+    {"", "cache-dir", ArgumentOption::OPTIONAL, ArgumentType::STR, "Cache directory", "", nullptr},
+    {"", "no-cache", ArgumentOption::OPTIONAL, ArgumentType::BOOL, "Disable cache", "", nullptr},
+    {"", "seed", ArgumentOption::OPTIONAL, ArgumentType::HEX, "Random seed", "", nullptr},
+    {"", "config", ArgumentOption::OPTIONAL, ArgumentType::FILE, "Configuration file", "", nullptr},
+};
+
+}
+
+int main(int argc, char** argv)
+{
+    ArgumentParser args("Startup latency probe.");
+    args.register_options(options);
+    args.register_positional(1);
+
+    try {
+        args.load_arguments(argc, argv);
+    } catch (std::logic_error&) {
+        return EXIT_FAILURE;
+    }
+
+    return args.parse_option<int>("threads") > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file arg_alloc.hpp
+ * @brief Counting of heap allocations -- header.
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Heap allocations counted by arg_alloc_counter.
+ */
+struct arg_alloc_stats {
+    std::size_t allocations; ///< number of allocations
+    std::size_t bytes;       ///< requested bytes
+};
+
+/**
+ * @brief Counter of heap allocations made by the current thread.
+ *
+ * Allocations are counted from construction of the counter until its destruction, nested
+ * counters count the allocations of the inner ones too. Allocations are reported by the
+ * hook arg_alloc_counter::record, which the program calls from its allocator. The global
+ * operator new can be replaced by a counting one with ARG_ALLOC_COUNTING_NEW in exactly one
+ * translation unit of the program.
+ *
+ * @code
+ * ARG_ALLOC_COUNTING_NEW
+ *
+ * arg_alloc_counter counter;
+ * args.load_arguments(argc, argv);
+ * auto allocs = counter.stats().allocations;
+ * @endcode
+ */
+class arg_alloc_counter
+{
+public:
+    arg_alloc_counter() noexcept;
+    ~arg_alloc_counter();
+
+    arg_alloc_counter(const arg_alloc_counter&) = delete;
+    arg_alloc_counter& operator=(const arg_alloc_counter&) = delete;
+
+    /**
+     * @brief Getter for allocations counted so far.
+     */
+    arg_alloc_stats stats() const noexcept { return stats_; }
+
+    /**
+     * @brief Method for resetting the counted allocations.
+     */
+    void restart() noexcept { stats_ = {0, 0}; }
+
+    /**
+     * @brief Hook recording a single allocation in all active counters of the thread.
+     *
+     * @param bytes requested bytes
+     */
+    static void record(std::size_t bytes) noexcept;
+
+private:
+    arg_alloc_stats stats_;   ///< counted allocations
+    arg_alloc_counter* prev_; ///< enclosing counter of the thread
+};
+
+/**
+ * @brief Definition of global operator new and delete reporting to arg_alloc_counter.
+ */
+#define ARG_ALLOC_COUNTING_NEW \
+    void* operator new(std::size_t n) \
+    { \
+        arg_alloc_counter::record(n); \
+        if (auto p = std::malloc(n ? n : 1)) { \
+            return p; \
+        } \
+        throw std::bad_alloc(); \
+    } \
+    void* operator new[](std::size_t n) { return operator new(n); } \
+    void operator delete(void* p) noexcept { std::free(p); } \
+    void operator delete[](void* p) noexcept { std::free(p); } \
+    void operator delete(void* p, std::size_t) noexcept { std::free(p); } \
+    void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,101 @@
+/**
+ * @file arg_cache.hpp
+ * @brief Cache of loaded command lines -- header.
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+#include "arg_parser.hpp"
+
+/**
+ * @brief Statistics of the argument cache.
+ */
+struct arg_cache_stats {
+    std::uint64_t hits;      ///< command lines found in the cache
+    std::uint64_t misses;    ///< command lines loaded by the parser
+    std::uint64_t evictions; ///< entries replaced by newer command lines
+    std::size_t entries;     ///< cached command lines
+
+    double hit_ratio() const {
+        return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+    }
+};
+
+/**
+ * @brief Cache of loaded and validated command lines.
+ *
+ * Command lines are keyed by a hash of their tokens. A hit returns the snapshot frozen when the
+ * command line was loaded for the first time, without tokenizing, validating or converting it
+ * again. Snapshots are immutable and shared by all callers.
+ *
+ * Lookups take a shared lock and run concurrently. A miss loads the command line into a scratch
+ * copy of the prototype and inserts the snapshot under an exclusive lock. When the cache is full
+ * an entry is evicted by the CLOCK algorithm, entries hit since the last sweep get a second chance.
+ * Command lines that fail to load are not cached, the error is thrown to the caller.
+ */
+class ArgumentCache
+{
+public:
+    /**
+     * @brief Constructor of the cache.
+     *
+     * @param prototype parser with registered options, groups, constraints and limits
+     * @param capacity maximum number of cached command lines
+     */
+    ArgumentCache(ArgumentParser prototype, std::size_t capacity);
+
+    ArgumentCache(const ArgumentCache&) = delete;
+    ArgumentCache& operator=(const ArgumentCache&) = delete;
+
+    /**
+     * @brief Method for getting loaded arguments of a command line.
+     *
+     * Throws std::logic_error if the command line is not valid.
+     *
+     * @param argc argument count
+     * @param argv argument vector
+     *
+     * @return snapshot of the loaded arguments
+     */
+    std::shared_ptr<const ArgumentSnapshot> parse(int argc, char** argv);
+
+    /**
+     * @brief Getter for cache statistics.
+     */
+    arg_cache_stats stats() const;
+
+    /**
+     * @brief Method for removing all cached command lines, statistics are kept.
+     */
+    void clear();
+
+private:
+    struct entry {
+        std::uint64_t hash = 0;
+        std::string key;                               ///< tokens, each terminated by NUL
+        std::shared_ptr<const ArgumentSnapshot> snap;  ///< loaded arguments, null for free entry
+        std::atomic<bool> referenced{false};           ///< hit since the last CLOCK sweep
+    };
+
+    ArgumentParser scratch_;                           ///< parser loading missed command lines
+    const std::size_t capacity_;                       ///< maximum number of entries
+    std::unique_ptr<entry[]> entries_;                 ///< cached command lines
+    std::unordered_map<std::uint64_t, std::size_t> index_; ///< hash to entry
+    std::size_t used_ = 0;                             ///< number of occupied entries
+    std::size_t hand_ = 0;                             ///< CLOCK hand
+
+    mutable std::shared_timed_mutex lock_;             ///< guards entries and index
+    std::mutex loader_;                                ///< serializes use of the scratch parser
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> evictions_{0};
+
+    std::shared_ptr<const ArgumentSnapshot> find_(std::uint64_t hash, int argc, char** argv) const;
+    std::size_t victim_();
+};
@@ -8,23 +8,28 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
 #include <sstream>
 #include <unordered_map>
 #include <set>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 /**
  * @brief Argument type enumerator
  */
-enum class ArgumentType {
+enum class ArgumentType : std::uint8_t {
     /*@{*/
     BOOL, ///< Boolean option
     INT,  ///< Integer option
     HEX,  ///< Hexadecimal format option
     FLT,  ///< Float option
     STR,  ///< String option
+    FILE, ///< File option, the value is a path mapped on access (see ArgumentParser::file_bytes)
     /*@}*/
 };
 
@@ -34,6 +39,29 @@ enum class ArgumentOption {
     INHERIT_GROUP
 };
 
+/**
+ * @brief Output formats of the effective configuration
+ */
+enum class ConfigFormat {
+    /*@{*/
+    JSON,      ///< Single JSON object
+    KEY_VALUE, ///< One option per line, tab separated fields
+    /*@}*/
+};
+
+/**
+ * @brief Character classes an option value can be restricted to
+ */
+enum class ArgumentPattern : std::uint8_t {
+    /*@{*/
+    ANY,        ///< No restriction
+    DIGITS,     ///< Decimal digits only
+    ALNUM,      ///< Letters and digits
+    IDENTIFIER, ///< Letter or underscore followed by letters, digits or underscores
+    HOSTNAME,   ///< Letters, digits, dots and hyphens
+    /*@}*/
+};
+
 
 /**
  * @brief Search key for loaded options
@@ -111,48 +139,216 @@ struct arg_key
 };
 
 /**
- * @brief Option data structure.
+ * @brief Interned option names.
+ *
+ * Short and long names of all options are stored back to back in a single pool
+ * in registration order. Lookup goes through an open-addressing table, so a name
+ * is resolved to the option index without walking the registered options.
  */
-struct arg_opt {
-    std::string value;                 ///< option value
-    ArgumentType type;                 ///< option type (see ArgumentType)
-    bool is_set;                       ///< flag if option is set
-    bool has_default;                  ///< flag if option has default value
-    std::string desc;                  ///< description for the option used in help text
+class arg_names
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
     /**
-     * @brief Defualt constructor of the option data
+     * @brief Method for interning names of a new option.
+     *
+     * @param ak option key
+     *
+     * @return index of the new option, npos if the key is empty or any of its names is already taken
      */
-    arg_opt() : value(), type(), is_set(false), has_default(false), desc() { }
+    std::size_t add(const arg_key& ak);
 
     /**
-     * @brief Constructor of the option data
+     * @brief Method for resolving option name to its index.
+     *
+     * @param name pointer to the name (does not have to be null-terminated)
+     * @param len name length
      *
-     * @param v option value
-     * @param t option type
-     * @param d option description
+     * @return option index or npos if no option has given name
      */
-     arg_opt(std::string v, ArgumentType t, std::string d, bool def = false)
-            : value(std::move(v)),
-              type(t),
-              is_set(def),
-              has_default(def),
-              desc(std::move(d))
-    { }
+    std::size_t find(const char* name, std::size_t len) const;
+
+    std::size_t find(const std::string& name) const { return find(name.data(), name.size()); }
+
+    std::string shr(std::size_t idx) const { return pool_.substr(refs_[idx].shr_off, refs_[idx].shr_len); }
+    std::string lng(std::size_t idx) const { return pool_.substr(refs_[idx].lng_off, refs_[idx].lng_len); }
+    arg_key key(std::size_t idx) const { return arg_key(shr(idx), lng(idx)); }
+
+    std::size_t size() const { return refs_.size(); }
+
+    /**
+     * @brief Heap memory held by the names.
+     */
+    std::size_t bytes() const;
+
+private:
+    struct name_ref {
+        std::uint32_t shr_off;
+        std::uint32_t lng_off;
+        std::uint16_t shr_len;
+        std::uint16_t lng_len;
+    };
+
+    std::string pool_;                 ///< concatenated names
+    std::vector<name_ref> refs_;       ///< names of each option
+    std::vector<std::uint32_t> slots_; ///< hash table, (index << 1 | is_long) + 1, 0 marks free slot
+    std::size_t used_ = 0;             ///< number of occupied slots
+
+    static std::uint32_t hash_(const char* name, std::size_t len);
+    bool equals_(std::uint32_t slot, const char* name, std::size_t len) const;
+    void insert_(std::uint32_t slot);
+    void grow_();
+};
+
+/**
+ * @brief Handle of a registered option.
+ *
+ * Returned by ArgumentParser::register_option, the handle is the dense option id with the
+ * option type. Accessors taking the handle index the option data directly without looking
+ * the option up by name. The handle is valid for the parser it was returned by, its copies
+ * and snapshots. An invalid handle reads as an unknown option: not set, empty value, T().
+ */
+struct arg_handle {
+    static constexpr std::uint32_t invalid = static_cast<std::uint32_t>(-1);
+
+    std::uint32_t index = invalid;          ///< option id
+    ArgumentType type = ArgumentType::BOOL; ///< option type
+
+    bool valid() const { return index != invalid; }
+
+    /**
+     * @brief Flag if the option was registered.
+     */
+    explicit operator bool() const { return valid(); }
+};
+
+/**
+ * @brief Memory footprint of registered options.
+ */
+struct arg_footprint {
+    std::size_t options;    ///< number of registered options
+    std::size_t hot_bytes;  ///< bytes touched while parsing (values, types, flags)
+    std::size_t cold_bytes; ///< bytes of names, help text and group bookkeeping owned by the parser
+    std::size_t shared_bytes; ///< bytes of option sets attached with ArgumentParser::add_parent
+
+    std::size_t bytes_per_option() const {
+        return options ? (hot_bytes + cold_bytes) / options : 0;
+    }
+};
+
+/**
+ * @brief Kinds of errors reported while loading arguments
+ */
+enum class ArgumentErrorCode : std::uint8_t {
+    /*@{*/
+    UNKNOWN_OPTION,       ///< Option is not registered
+    TOO_MANY_POSITIONALS, ///< More positional arguments than registered
+    POSITIONAL_ORDER,     ///< Positional argument precedes an option
+    INVALID_ARGUMENTS,    ///< Missing, conflicting or invalid options
+    TOO_MANY_TOKENS,      ///< arg_limits::max_tokens exceeded
+    TOKEN_TOO_LONG,       ///< arg_limits::max_token_bytes exceeded
+    INPUT_TOO_LONG,       ///< arg_limits::max_total_bytes exceeded
+    TOO_MANY_ELEMENTS,    ///< arg_limits::max_list_elements exceeded
+    /*@}*/
+};
+
+/**
+ * @brief Error of loading arguments.
+ *
+ * Derived from std::logic_error, so existing handlers keep working. The code and the index of
+ * the offending token let callers react without parsing the message.
+ */
+class ArgumentError : public std::logic_error
+{
+public:
+    static constexpr std::size_t no_token = static_cast<std::size_t>(-1);
+
+    ArgumentError(ArgumentErrorCode code, const std::string& msg, std::size_t token = no_token, std::size_t limit = 0)
+        : std::logic_error(msg), code_(code), token_(token), limit_(limit)
+    {
+    }
+
+    ArgumentErrorCode code() const { return code_; }
 
     /**
-     * @brief Copy-constructor of the option data structure
+     * @brief Index of the offending token, the executable is token 0.
      *
-     * @param other Input structure
+     * @return token index or no_token if the error does not belong to a single token
+     */
+    std::size_t token() const { return token_; }
+
+    /**
+     * @brief Exceeded limit, 0 for errors not caused by arg_limits.
+     */
+    std::size_t limit() const { return limit_; }
+
+private:
+    ArgumentErrorCode code_;
+    std::size_t token_;
+    std::size_t limit_;
+};
+
+/**
+ * @brief Limits of loaded command lines.
+ *
+ * Command lines from untrusted sources are rejected with ArgumentError as soon as a limit is
+ * exceeded, so time and memory spent on a single load stay bounded. Default limits are unlimited.
+ */
+struct arg_limits {
+    static constexpr std::size_t unlimited = static_cast<std::size_t>(-1);
+
+    std::size_t max_tokens = unlimited;        ///< tokens after the executable
+    std::size_t max_token_bytes = unlimited;   ///< bytes of a single token, including the executable
+    std::size_t max_total_bytes = unlimited;   ///< bytes of the whole command line, with one separator per token
+    std::size_t max_list_elements = unlimited; ///< occurrences of a single option, repeated or bundled
+
+    /**
+     * @brief Limits suitable for command lines of untrusted users.
      */
-    arg_opt(const arg_opt& other) = default;
+    static arg_limits untrusted() { return arg_limits{256, 4096, 64 * 1024, 64}; }
+};
 
+/**
+ * @brief Read-only view of bytes.
+ */
+struct arg_bytes {
+    const unsigned char* data; ///< first byte, null if empty
+    std::size_t size;          ///< number of bytes
+
+    const unsigned char* begin() const { return data; }
+    const unsigned char* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * @brief Read-only memory mapping of a file.
+ *
+ * The file is mapped when the object is constructed and unmapped when it is destroyed.
+ * Platforms without mmap read the file into memory instead.
+ */
+class arg_mapping
+{
+public:
     /**
-     * @brief Copy-assignment operator for the option data structure
+     * @brief Constructor mapping the file, throws std::logic_error if the file cannot be mapped.
      *
-     * @param other Input structure
+     * @param path file path
      */
-    inline arg_opt& operator= (const arg_opt& other) = default;
+    explicit arg_mapping(std::string path);
+    ~arg_mapping();
+
+    arg_mapping(const arg_mapping&) = delete;
+    arg_mapping& operator=(const arg_mapping&) = delete;
+
+    const std::string& path() const { return path_; }
+    arg_bytes bytes() const { return {data_, size_}; }
+
+private:
+    std::string path_;
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::vector<unsigned char> copy_; ///< file contents where mmap is not available
 };
 
 /**
@@ -190,18 +386,58 @@ struct arg_pos {
     inline arg_pos& operator= (const arg_pos& other) = default;
 };
 
+/**
+ * @brief Constraints checked when an option value is loaded.
+ */
+struct arg_constraint {
+    std::vector<std::string> choices; ///< sorted allowed values, empty if any value is allowed
+    bool has_range = false;           ///< flag if min and max are used
+    double min = 0.0;                 ///< smallest allowed numeric value
+    double max = 0.0;                 ///< largest allowed numeric value
+    ArgumentPattern pattern = ArgumentPattern::ANY; ///< allowed characters
+
+    /**
+     * @brief Method for checking an option value.
+     *
+     * @param value value to check
+     * @param type option type used to convert the value for range check
+     *
+     * @return empty string if value is valid, reason of rejection otherwise
+     */
+    std::string check(const std::string& value, ArgumentType type) const;
+};
+
 struct arg_default : std::pair<bool, std::string> {
     arg_default() : std::pair<bool,std::string>(false, "") {}
     explicit arg_default(const std::string& v) : std::pair<bool,std::string>(true, v) {}
 };
 
-struct arg_group : std::set<arg_key>
+/**
+ * @brief Option specification for ArgumentParser::register_options.
+ *
+ * The specification holds only literals, so a table of options declared constexpr is
+ * constant initialized and costs nothing until it is registered.
+ */
+struct arg_spec {
+    const char* shr;           ///< short option name, "" if none
+    const char* lng;           ///< long option name, "" if none
+    ArgumentOption opt;        ///< required flag
+    ArgumentType type;         ///< option type
+    const char* desc;          ///< option description
+    const char* group;         ///< mutually exclusive group, "" if none
+    const char* default_value; ///< default value, nullptr if none
+};
+
+/**
+ * @brief Mutually exclusive group -- indices of its options.
+ */
+struct arg_group : std::vector<std::size_t>
 {
 protected:
     bool mandatory_;
 
 public:
-    explicit arg_group(bool m = false) : std::set<arg_key>(), mandatory_(m) {}
+    explicit arg_group(bool m = false) : std::vector<std::size_t>(), mandatory_(m) {}
 
     bool mandatory() { return mandatory_; }
 
@@ -210,63 +446,414 @@ public:
     }
 };
 
+class ArgumentParser;
+
+/**
+ * @brief Set of registered options.
+ *
+ * The set holds everything that does not change while arguments are loaded: names, types,
+ * descriptions, default values and required flags. Sets can be attached to any number of parsers
+ * with ArgumentParser::add_parent, the parsers share the set and keep only their own option values.
+ * A set must not be modified once it is attached.
+ */
+class arg_option_set
+{
+public:
+    /**
+     * @brief Method for registering option to the set.
+     *
+     * Sets have no mutually exclusive groups, ArgumentOption::INHERIT_GROUP is rejected.
+     *
+     * @return true if option was successfully registered
+     */
+    bool register_option(const arg_key& ak,
+                         ArgumentOption opt,
+                         ArgumentType type,
+                         const std::string& desc,
+                         const arg_default& default_value = arg_default());
+
+    std::size_t size() const { return types_.size(); }
+
+    const arg_names& names() const { return names_; }
+
+    ArgumentType type(std::size_t idx) const { return types_[idx]; }
+
+    bool has_default(std::size_t idx) const { return has_default_[idx] != 0; }
+
+    std::string desc(std::size_t idx) const {
+        return desc_pool_.substr(desc_offsets_[idx], desc_offsets_[idx + 1] - desc_offsets_[idx]);
+    }
+
+    std::string default_value(std::size_t idx) const {
+        return default_pool_.substr(default_offsets_[idx], default_offsets_[idx + 1] - default_offsets_[idx]);
+    }
+
+    void assign_default(std::size_t idx, std::string& dst) const {
+        dst.assign(default_pool_, default_offsets_[idx], default_offsets_[idx + 1] - default_offsets_[idx]);
+    }
+
+    /**
+     * @brief Getter for indices of required options.
+     */
+    const std::vector<std::size_t>& mandatory() const { return mandatory_; }
+
+    /**
+     * @brief Heap memory held by the set.
+     */
+    std::size_t bytes() const;
+
+private:
+    friend class ArgumentParser;
+
+    arg_names names_;                            ///< interned option names
+    std::vector<ArgumentType> types_;            ///< option types
+    std::vector<std::uint8_t> has_default_;      ///< flags if options have default value
+    std::string desc_pool_;                      ///< concatenated option descriptions
+    std::vector<std::uint32_t> desc_offsets_{0}; ///< description boundaries in desc_pool_
+    std::string default_pool_;                   ///< concatenated default values
+    std::vector<std::uint32_t> default_offsets_{0}; ///< default value boundaries in default_pool_
+    std::vector<std::size_t> mandatory_;         ///< required options
+
+    std::size_t add_(const arg_key& ak, ArgumentType type, const std::string& desc, const arg_default& default_value);
+    void make_mandatory_(std::size_t idx);
+};
+
+/**
+ * @brief Option sets making up the option ids of a parser.
+ *
+ * Each set occupies a contiguous range of ids in the order the sets were added. Options registered
+ * directly to a parser go to a set owned by it; the owned set is copied before modification when
+ * it is shared, so copies of a parser and its snapshots never see later registrations.
+ */
+class arg_segments
+{
+public:
+    static constexpr std::size_t npos = arg_names::npos;
+
+    std::size_t find(const char* name, std::size_t len) const;
+
+    std::size_t find(const std::string& name) const { return find(name.data(), name.size()); }
+
+    /**
+     * @brief Total number of options.
+     */
+    std::size_t size() const { return list_.empty() ? 0 : list_.back().base + list_.back().set->size(); }
+
+    /**
+     * @brief Method for finding the set an option belongs to.
+     *
+     * @param id option id
+     * @param local index of the option within the returned set
+     *
+     * @return set containing the option
+     */
+    const arg_option_set& locate(std::size_t id, std::size_t& local) const;
+
+    arg_key key(std::size_t id) const { std::size_t i; return locate(id, i).names().key(i); }
+    ArgumentType type(std::size_t id) const { std::size_t i; return locate(id, i).type(i); }
+    bool has_default(std::size_t id) const { std::size_t i; return locate(id, i).has_default(i); }
+    std::string desc(std::size_t id) const { std::size_t i; return locate(id, i).desc(i); }
+    std::string default_value(std::size_t id) const { std::size_t i; return locate(id, i).default_value(i); }
+
+    /**
+     * @brief Flag if no name of the option resolves to it, all its names are taken by earlier options.
+     */
+    bool shadowed(std::size_t id) const;
+
+    /**
+     * @brief Method for calling a function with id of every required option.
+     *
+     * Shadowed options cannot be given, so they are not required.
+     */
+    template<typename F> void for_each_mandatory(F f) const {
+        for (auto&& S : list_) {
+            for (auto M : S.set->mandatory()) {
+                if (!shadowed(S.base + M)) {
+                    f(S.base + M);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Method for attaching a shared set after current options.
+     */
+    void attach(std::shared_ptr<const arg_option_set> set);
+
+    /**
+     * @brief Getter for the set options registered to the parser go to.
+     *
+     * @return owned set at the end of the ids, created or copied if necessary
+     */
+    arg_option_set& own();
+
+    /**
+     * @brief Heap memory of the sets.
+     *
+     * @param shared true for attached sets, false for sets owned by the parser
+     */
+    std::size_t bytes(bool shared) const;
+
+private:
+    struct segment {
+        std::shared_ptr<const arg_option_set> set; ///< options
+        std::size_t base;                          ///< id of the first option
+        bool owned;                                ///< set was created by the parser
+    };
+
+    std::vector<segment> list_; ///< sets ordered by base
+    bool own_open_ = false;     ///< last set is owned and accepts new options
+};
+
+/**
+ * @brief Immutable snapshot of loaded arguments.
+ *
+ * Snapshot is created by ArgumentParser::freeze after the arguments were loaded. Option values
+ * are converted once when the snapshot is created, all accessors are const and the snapshot is
+ * never modified afterwards, so any number of threads can read it without synchronization.
+ */
+class ArgumentSnapshot
+{
+public:
+    static constexpr std::size_t npos = arg_names::npos;
+
+    /**
+     * @brief Method for resolving option name to its index.
+     *
+     * @param key short or long option name
+     *
+     * @return option index or npos if the option does not exist
+     */
+    std::size_t index(const std::string& key) const { return segments_.find(key); }
+
+    bool has_option(const std::string& key) const { return index(key) != npos; }
+
+    bool option_is_set(const std::string& key) const {
+        const auto id = index(key);
+
+        return id != npos && entries_[id].is_set;
+    }
+
+    bool option_is_set(std::size_t id) const { return id < entries_.size() && entries_[id].is_set; }
+
+    /**
+     * @brief Method for getting converted option value.
+     *
+     * Integral types get INT and HEX values, floating point types get FLT values, bool gets the set flag
+     * and std::string gets the value as it was loaded.
+     *
+     * @tparam T return type
+     * @param key short or long option name
+     *
+     * @return option value or T() if the option is unknown or not set
+     */
+    template<typename T> T get(const std::string& key) const {
+        const auto id = index(key);
+
+        return id != npos ? get<T>(id) : T();
+    }
+
+    template<typename T> T get(std::size_t id) const {
+        return id < entries_.size() && entries_[id].is_set ? get_(id, static_cast<T*>(nullptr)) : T();
+    }
+
+    template<typename T> T get(arg_handle h) const { return h.valid() ? get<T>(static_cast<std::size_t>(h.index)) : T(); }
+
+    bool option_is_set(arg_handle h) const { return h.valid() && entries_[h.index].is_set; }
+
+    const std::string& operator[] (arg_handle h) const { return h.valid() ? strings_[h.index] : empty_; }
+
+    /**
+     * @brief Operator for getting the option value without conversion.
+     *
+     * @param key short or long option name
+     *
+     * @return option value or empty string if the option is unknown
+     */
+    const std::string& operator[] (const std::string& key) const {
+        const auto id = index(key);
+
+        return id != npos ? strings_[id] : empty_;
+    }
+
+    /**
+     * @brief Operator for getting the positional parameter value.
+     *
+     * @param idx index of positional argument
+     *
+     * @return value of positional parameter
+     */
+    const std::string& operator[] (std::size_t idx) const { return positional_.at(idx); }
+
+    const std::string& value(std::size_t id) const { return id < strings_.size() ? strings_[id] : empty_; }
+
+    std::size_t positional_count() const { return positional_.size(); }
+
+    std::size_t size() const { return entries_.size(); }
+
+    arg_key key(std::size_t id) const { return segments_.key(id); }
+
+    const std::string& exec_name() const { return exec_name_; }
+
+private:
+    friend class ArgumentParser;
+
+    /**
+     * @brief Pre-converted option value.
+     */
+    struct entry {
+        std::int64_t int_val; ///< value of INT and HEX options, truncated FLT value saturated to the range
+        double flt_val;       ///< value of FLT options, INT and HEX value as floating point
+        ArgumentType type;    ///< option type
+        bool is_set;          ///< flag if option is set
+    };
+
+    arg_segments segments_;               ///< option names
+    std::vector<entry> entries_;          ///< converted values, indexed by option id
+    std::vector<std::string> strings_;    ///< values as loaded
+    std::vector<std::string> positional_; ///< positional values
+    std::string exec_name_;               ///< executable name
+    std::string empty_;                   ///< returned for unknown options
+
+    ArgumentSnapshot() = default;
+
+    bool get_(std::size_t id, bool*) const { return entries_[id].is_set; }
+
+    std::string get_(std::size_t id, std::string*) const { return strings_[id]; }
+
+    template<typename T>
+    std::enable_if_t<std::is_integral<T>::value, T> get_(std::size_t id, T*) const {
+        return static_cast<T>(entries_[id].int_val);
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, T> get_(std::size_t id, T*) const {
+        return static_cast<T>(entries_[id].flt_val);
+    }
+};
+
 /**
  * @brief Argument parser class -- Command line argument parser
  */
 class ArgumentParser
 {
 protected:
-    using options_t = std::map<arg_key, arg_opt>;
+    static constexpr std::size_t npos = arg_names::npos;
+
+    /**
+     * @brief Values of set_ flags
+     */
+    enum set_flag : std::uint8_t {
+        IS_SET = 1,  ///< option is set (from command line or by default value)
+        IS_GIVEN = 3 ///< option was given on command line
+    };
+
     const unsigned int OPT_WIDTH_;       ///< option name field width
 
     std::string exec_name_;                                 ///< executable name
     std::vector<arg_pos> positional_;                       ///< positional arguments
-    options_t options_;                                     ///< options
-    std::set<arg_key> mandatory_;                           ///< mandatory options
+
+    // hot option data, indexed by option id in registration order
+    std::vector<std::string> values_;                       ///< option values
+    std::vector<ArgumentType> types_;                       ///< option types
+    std::vector<std::uint8_t> set_;                         ///< flags if options are set (see set_flag)
+
+    std::vector<std::uint32_t> constraint_idx_;             ///< 1-based index to constraints_, 0 if unconstrained
+
+    // cold option data
+    arg_segments segments_;                                 ///< names, types, descriptions and defaults
+    std::vector<arg_constraint> constraints_;               ///< value constraints
     std::unordered_map<std::string, arg_group> mtx_groups_; ///< Mutually exclusive groups
 
     std::string prog_desc_;              ///< program description
     std::string usage_;                  ///< program usage
 
-    bool option_is_mutually_exclusive_(const arg_key& ak)
+    arg_limits limits_;                         ///< limits of loaded command lines
+    std::vector<std::uint32_t> occurrences_;    ///< occurrences of options, used only with max_list_elements
+
+    bool pass_through_ = false;                 ///< unknown arguments are forwarded instead of rejected
+    std::vector<std::size_t> forwarded_;        ///< indices of forwarded arguments in the loaded argv
+    std::vector<char*> forward_argv_;           ///< forwarded arguments, null-terminated
+
+    /// files of FILE options mapped so far, by option id
+    mutable std::vector<std::pair<std::size_t, std::shared_ptr<const arg_mapping>>> mappings_;
+
+    bool option_is_mutually_exclusive_(std::size_t id) const
     {
         return std::any_of(mtx_groups_.begin(),
                            mtx_groups_.end(),
-                           [&ak](auto& group)
+                           [id](auto& group)
                            {
-                               return group.second.find(ak) != group.second.end();
+                               return std::find(group.second.begin(), group.second.end(), id) != group.second.end();
                            }
         );
     }
 
-    void make_option_mandatory_(const arg_key& ak)
-    {
-        mandatory_.emplace(ak);
-    }
-
     decltype(auto) check_mandatory_options_();
     decltype(auto) check_mandatory_option_groups_();
     decltype(auto) check_option_conflicts_();
 
-    const options_t::iterator find_option_(const std::string& key) {
-        return std::find_if(options_.begin(),
-                            options_.end(),
-                            [&key](const std::pair<arg_key, arg_opt>& a) -> bool
-                            {
-                                return a.first.shr == key || a.first.lng == key;
-                            }
-        );
+    std::string option_name_(std::size_t id) const;
+
+    // options of attached sets get their hot data when arguments are loaded, until then
+    // the accessors fall back to the set
+    ArgumentType type_(std::size_t id) const { return id < types_.size() ? types_[id] : segments_.type(id); }
+    bool is_set_(std::size_t id) const { return id < set_.size() ? set_[id] != 0 : segments_.has_default(id); }
+    std::string value_(std::size_t id) const { return id < values_.size() ? values_[id] : segments_.default_value(id); }
+
+    void materialize_();
+
+    template<typename Sink> void dump_config_(Sink& out, ConfigFormat fmt) const;
+
+    arg_constraint* constraint_(const std::string& key);
+
+    void set_exec_name_(const char* path, std::size_t len);
+    void set_value_(std::size_t id, const char* val, std::size_t len, std::string& invalid);
+    bool is_negative_number_(std::size_t id, const char* tok, std::size_t len) const;
+    void mark_given_(std::size_t id, std::size_t tok);
+    bool is_bundle_(const char* name, std::size_t len) const;
+    void forward_(std::size_t idx, const char* tok);
+    template<typename Tokens> void load_tokens_(Tokens& tokens, std::size_t total);
+    void check_loaded_arguments_(std::size_t pos, const std::string& invalid);
+
+    std::size_t find_option_(const std::string& key) const {
+        return segments_.find(key);
     }
 
-    const options_t::iterator find_option_(const arg_key& ak) {
+    std::size_t find_option_(const arg_key& ak) const {
 
-        auto&& opt = find_option_(ak.shr);
+        auto id = ak.shr.empty() ? npos : find_option_(ak.shr);
 
-        if (opt == options_.end()) {
-            find_option_(ak.lng);
+        if (id == npos && !ak.lng.empty()) {
+            id = find_option_(ak.lng);
         }
 
-        return opt;
+        return id;
+    }
+
+    template<typename T> T parse_option_(std::size_t id) const
+    {
+        std::stringstream ss;
+
+        if (id != npos && is_set_(id)) {
+            ss << value_(id);
+            T opt_val;
+            switch (type_(id)) {
+                case ArgumentType::BOOL:
+                    opt_val = true;
+                    break;
+                case ArgumentType::HEX:
+                        ss << std::hex;
+                        ss >> opt_val;
+                    break;
+                default:
+                    if (!(ss >> opt_val)) {
+                        throw std::logic_error("Cannot convert option to given type. (" + ss.str() +")");
+                    }
+            }
+            return opt_val;
+        }
+        return T();
     }
 
 public:
@@ -284,7 +871,7 @@ public:
      *
      * @return Name of the current binary executable.
      */
-    auto exec_name()
+    auto exec_name() const
     {
         return exec_name_;
     }
@@ -298,15 +885,32 @@ public:
      * @param type option type
      * @param desc option description
      *
-     * @return true if option was successfully registered in ArgumentParser
+     * @return handle of the option, invalid handle if the option was not registered
      */
 
-    bool register_option(const arg_key& ak,
-                         ArgumentOption opt,
-                         ArgumentType type,
-                         const std::string& desc,
-                         const std::string& excl_group = "",
-                         const arg_default& default_value = arg_default());
+    arg_handle register_option(const arg_key& ak,
+                               ArgumentOption opt,
+                               ArgumentType type,
+                               const std::string& desc,
+                               const std::string& excl_group = "",
+                               const arg_default& default_value = arg_default());
+
+    /**
+     * @brief Method for registering a table of options.
+     *
+     * Options are registered in table order as with ArgumentParser::register_option, storage
+     * for all of them is reserved at once.
+     *
+     * @param specs option specifications
+     * @param count number of specifications
+     *
+     * @return number of registered options
+     */
+    std::size_t register_options(const arg_spec* specs, std::size_t count);
+
+    template<std::size_t N> std::size_t register_options(const arg_spec (&specs)[N]) {
+        return register_options(specs, N);
+    }
 
     /**
      * @brief Method for registering positional arguments. 
@@ -317,19 +921,69 @@ public:
     void register_positional(unsigned count,
                              std::vector<std::string> names=std::vector<std::string>());
 
+    /**
+     * @brief Method for attaching a shared option set.
+     *
+     * Options of the set are added after the options registered so far. The set is not copied,
+     * attaching takes constant time regardless of the number of options in the set. If a name
+     * of the set is already used, the option registered earlier takes precedence. An option of
+     * the set whose names are all taken cannot be given and is not required.
+     *
+     * @param set option set
+     */
+    void add_parent(std::shared_ptr<const arg_option_set> set) { segments_.attach(std::move(set)); }
+
     bool add_mutually_exclusive_group(const std::string& grp_name, bool required = false) {
         return mtx_groups_.emplace(grp_name, arg_group(required)).second;
     }
 
     bool insert_into_group(const std::string& grp_name, const arg_key& ak) {
-        if (mtx_groups_.count(grp_name)) {
-            mtx_groups_.at(grp_name).emplace(ak).second;
+        const auto id = find_option_(ak);
+
+        if (mtx_groups_.count(grp_name) && id != npos) {
+            auto&& grp = mtx_groups_.at(grp_name);
+            if (std::find(grp.begin(), grp.end(), id) == grp.end()) {
+                grp.push_back(id);
+            }
             return true;
         }
 
         return false;
     }
 
+    /**
+     * @brief Method for restricting option value to a set of choices.
+     *
+     * Choices are kept sorted so the lookup stays logarithmic for large sets.
+     *
+     * @param key short or long option name
+     * @param choices allowed values
+     *
+     * @return true if the constraint was added, false for unknown or BOOL options
+     */
+    bool add_choices(const std::string& key, std::vector<std::string> choices);
+
+    /**
+     * @brief Method for restricting numeric option value to a range.
+     *
+     * @param key short or long option name
+     * @param min smallest allowed value
+     * @param max largest allowed value
+     *
+     * @return true if the constraint was added, false for unknown or non-numeric options
+     */
+    bool add_range(const std::string& key, double min, double max);
+
+    /**
+     * @brief Method for restricting option value to a character class.
+     *
+     * @param key short or long option name
+     * @param pattern allowed characters
+     *
+     * @return true if the constraint was added, false for unknown or BOOL options
+     */
+    bool add_pattern(const std::string& key, ArgumentPattern pattern);
+
     /**
      * @brief Method for loading CLI arguments. 
      *
@@ -338,16 +992,80 @@ public:
      */
     void load_arguments(int argc, char **argv);
 
-    template<typename T> bool has_option(const T& key) {
-        return find_option_(key) != options_.end();
+    /**
+     * @brief Method for loading arguments from a NUL-delimited buffer.
+     *
+     * The buffer has the layout of /proc/<pid>/cmdline, the first token is the executable.
+     * Tokens are read in place, no argv array is built. In pass-through mode the buffer has to
+     * end with NUL, because forwarded tokens are handed out as C strings.
+     *
+     * @param buf command line buffer
+     * @param len buffer length, including the terminating NUL if present
+     */
+    void load_cmdline(const char* buf, std::size_t len);
+
+    /**
+     * @brief Method for clearing loaded arguments.
+     *
+     * Options get their default values back and positional values are cleared, so the parser
+     * can load another command line. Buffers of option values are reused.
+     */
+    void reset();
+
+    /**
+     * @brief Method for limiting loaded command lines.
+     *
+     * Loading a command line exceeding any of the limits throws ArgumentError with the code of
+     * the exceeded limit, before the rest of the command line is read.
+     *
+     * @param limits limits of loaded command lines, use arg_limits::untrusted for untrusted input
+     */
+    void set_limits(const arg_limits& limits) { limits_ = limits; }
+
+    const arg_limits& limits() const { return limits_; }
+
+    /**
+     * @brief Method for enabling pass-through of unknown arguments.
+     *
+     * In pass-through mode unknown options, positional arguments beyond the registered ones and
+     * all arguments after "--" are not rejected but forwarded, e.g. to a child process. Unknown
+     * options are forwarded after positional arguments too, known ones still have to precede them.
+     * Options of the child taking a value must be written as --option=value or after "--".
+     *
+     * @param enable true to forward unknown arguments
+     */
+    void set_pass_through(bool enable) { pass_through_ = enable; }
+
+    /**
+     * @brief Getter for indices of forwarded arguments in the loaded argv.
+     */
+    const std::vector<std::size_t>& forwarded() const { return forwarded_; }
+
+    /**
+     * @brief Getter for forwarded arguments ready to be passed to exec.
+     *
+     * The array is null-terminated and points into the loaded argv, no argument is copied.
+     * It is valid as long as the argv and the parser are, until the next load or reset.
+     *
+     * @return forwarded arguments, null if pass-through is disabled or nothing was loaded
+     */
+    char* const* forward_argv() const { return forward_argv_.empty() ? nullptr : forward_argv_.data(); }
+
+    template<typename T> bool has_option(const T& key) const {
+        return find_option_(key) != npos;
     }
 
-    template<typename T> bool option_is_set(const T& key) {
-        const auto opt = find_option_(key);
+    template<typename T> bool option_is_set(const T& key) const {
+        const auto id = find_option_(key);
 
-        return has_option(key) && opt->second.is_set;
+        return id != npos && is_set_(id);
     }
 
+    /**
+     * @brief Method for checking an option by its handle, without lookup.
+     */
+    bool option_is_set(arg_handle h) const { return h.valid() && set_[h.index] != 0; }
+
     /**
      * @brief Operator for getting the option value.
      *
@@ -361,20 +1079,31 @@ public:
      */
     const std::string operator[] (const std::string& key) const
     {
-        auto opt = std::find_if(options_.begin(),
-                                options_.end(),
-                                [&key](const std::pair<arg_key, arg_opt>& a) -> bool
-                                {
-                                    return a.first.shr == key || a.first.lng == key;
-                                }
-        );
-        if (opt != options_.end()) {
-            return opt->second.value;
+        const auto id = find_option_(key);
+
+        if (id != npos) {
+            return value_(id);
         }
 
         return "";
     }
 
+    /**
+     * @brief Operator for getting the option value by its handle.
+     *
+     * The value is neither looked up nor copied. For converted values in hot loops
+     * use ArgumentSnapshot::get with the same handle.
+     *
+     * @param h handle returned by ArgumentParser::register_option
+     *
+     * @return Option value, empty string for an invalid handle.
+     */
+    const std::string& operator[] (arg_handle h) const {
+        static const std::string empty;
+
+        return h.valid() ? values_[h.index] : empty;
+    }
+
     /**
      * @brief Operator for getting the positional parameter value.
      *
@@ -401,39 +1130,31 @@ public:
      *
      * @return option value
      */
-    template<typename T> decltype(auto) parse_option(const std::string& opt)
+    template<typename T> decltype(auto) parse_option(const std::string& opt) const
     {
-        auto&& val = std::find_if(this->options_.begin(),
-                                  this->options_.end(),
-                                  [opt](const std::pair<arg_key, arg_opt>& a)
-                                  {
-                                      return a.first.shr == opt || a.first.lng == opt;
-                                  }
-        );
-
-        std::stringstream ss;
+        return parse_option_<T>(find_option_(opt));
+    }
 
-        if (val != options_.end() && val->second.is_set) {
-            ss << val->second.value;
-            T opt_val;
-            switch (val->second.type) {
-                case ArgumentType::BOOL:
-                    opt_val = val->second.is_set;
-                    break;
-                case ArgumentType::HEX:
-                        ss << std::hex;
-                        ss >> opt_val;
-                    break;
-                default:
-                    if (!(ss >> opt_val)) {
-                        throw std::logic_error("Cannot convert option to given type. (" + ss.str() +")");
-                    }
-            }
-            return opt_val;
-        }
-        return T();
+    template<typename T> decltype(auto) parse_option(arg_handle h) const
+    {
+        return parse_option_<T>(h.valid() ? h.index : npos);
     }
 
+    /**
+     * @brief Method for getting contents of a FILE option.
+     *
+     * The file named by the option value is mapped on the first call and stays mapped until the
+     * parser and all its copies are destroyed, reset or load a different path. Returned bytes are
+     * valid until then. Mapping is not synchronized, concurrent first calls need external locking.
+     *
+     * Throws std::logic_error if the option is not a FILE option or the file cannot be mapped.
+     *
+     * @param key option name
+     *
+     * @return file contents, empty if the option is not set
+     */
+    arg_bytes file_bytes(const std::string& key) const;
+
     /**
      * @brief Method for getting positional argument value. 
      *
@@ -444,7 +1165,7 @@ public:
      *
      * @return argument value
      */
-    template<typename T> decltype(auto) parse_positional(int idx)
+    template<typename T> decltype(auto) parse_positional(int idx) const
     {
         std::stringstream ss;
 
@@ -462,6 +1183,79 @@ public:
         return opt_val;
     }
 
+    /**
+     * @brief Method for creating an immutable snapshot of loaded arguments.
+     *
+     * The snapshot can be shared between threads, the parser itself can be modified or destroyed
+     * without affecting it.
+     *
+     * @return snapshot of current option values, set flags and positional arguments
+     */
+    std::shared_ptr<const ArgumentSnapshot> freeze() const;
+
+    /**
+     * @brief Method for storing the parsed state into a binary snapshot.
+     *
+     * The snapshot contains the executable name, option names, types, values and set flags
+     * and positional values. Descriptions, groups and constraints are not stored, the state
+     * in the snapshot is already validated. The format is versioned and uses host byte order,
+     * it is meant to be passed to child processes on the same machine.
+     *
+     * @return snapshot data
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief Method for loading parsed state from a binary snapshot.
+     *
+     * Options stored in the snapshot are matched by name, options not registered yet are
+     * registered as optional ones, so a child process does not have to repeat registration
+     * nor parsing. Throws std::logic_error if the snapshot is malformed, of different version or
+     * if a registered option has a different type than the stored one.
+     *
+     * @param data snapshot data
+     * @param size snapshot size in bytes
+     */
+    void deserialize(const char* data, std::size_t size);
+
+    void deserialize(const std::string& data) { deserialize(data.data(), data.size()); }
+
+    /**
+     * @brief Method for registering built-in option --print-config.
+     *
+     * As with --help, the program decides what to do when the option is set, typically
+     * it calls print_config and exits.
+     *
+     * @return handle of the option, invalid handle if the option was not registered
+     */
+    arg_handle register_print_config_option() {
+        return register_option({"", "print-config"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL,
+                               "Print effective configuration and exit");
+    }
+
+    /**
+     * @brief Method for serializing the effective configuration.
+     *
+     * Every option is written with its value, type, source (set on command line, default or unset)
+     * and the groups it belongs to, followed by positional arguments. The output is built in one
+     * buffer allocated to the exact size.
+     *
+     * @param fmt output format
+     *
+     * @return serialized configuration
+     */
+    std::string dump_config(ConfigFormat fmt = ConfigFormat::JSON) const;
+
+    /**
+     * @brief Method for printing the effective configuration to standard output in a single write.
+     *
+     * On POSIX systems the document goes straight to write(2), repeated only after a short
+     * or interrupted write; elsewhere it is written through stdio.
+     *
+     * @param fmt output format
+     */
+    void print_config(ConfigFormat fmt = ConfigFormat::JSON) const;
+
     /**
      * @brief Method for printing help text.
      */
@@ -478,5 +1272,12 @@ public:
      * @param txt new usage text
      */
     void set_usage_text(const std::string& txt) { this->usage_ = txt; }
+
+    /**
+     * @brief Method for reporting memory used by registered options.
+     *
+     * @return hot and cold bytes of the option storage
+     */
+    arg_footprint footprint() const;
 };
 
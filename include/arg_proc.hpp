@@ -0,0 +1,68 @@
+/**
+ * @file arg_proc.hpp
+ * @brief Parsing command lines of running processes -- header.
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <functional>
+
+#include "arg_parser.hpp"
+
+/**
+ * @brief Scanner parsing command lines of running processes against one schema.
+ *
+ * The scanner walks /proc and loads /proc/<pid>/cmdline of every process into a copy of the
+ * schema parser with ArgumentParser::load_cmdline. The parser and the read buffer are reused
+ * for all processes, option sets of the schema are shared, not copied.
+ *
+ * Scanning is supported on Linux only, elsewhere no process is reported.
+ */
+class ProcessScanner
+{
+public:
+    /**
+     * @brief Function called for every scanned process.
+     *
+     * The parser holds the loaded command line and is valid only during the call. The error is
+     * empty if the command line matches the schema, otherwise it holds the parser error.
+     */
+    using callback_t = std::function<void(int pid, const ArgumentParser& args, const std::string& error)>;
+
+    /**
+     * @brief Constructor of the scanner.
+     *
+     * @param schema parser with registered options and positional arguments
+     * @param proc_root directory with process entries
+     */
+    explicit ProcessScanner(const ArgumentParser& schema, std::string proc_root = "/proc");
+
+    /**
+     * @brief Method for restricting the scan to one executable.
+     *
+     * Processes with a different executable name are skipped before their command line is parsed.
+     *
+     * @param name executable name without path, empty to scan all processes
+     */
+    void filter_exec(std::string name) { exec_filter_ = std::move(name); }
+
+    /**
+     * @brief Method for parsing command lines of all processes.
+     *
+     * @param cb function called for every process with non-empty command line
+     *
+     * @return number of parsed processes
+     */
+    std::size_t scan(const callback_t& cb);
+
+private:
+    ArgumentParser args_;    ///< parser reused for all processes
+    std::string proc_root_;  ///< directory with process entries
+    std::string exec_filter_; ///< executable name to scan
+    std::vector<char> buf_;  ///< command line buffer
+    std::string path_;       ///< path of the command line file
+    std::string error_;      ///< error of the last parsed command line
+
+    bool read_cmdline_(const char* pid, std::size_t& len);
+};
@@ -0,0 +1,100 @@
+/**
+ * @file arg_reload.hpp
+ * @brief Reloadable arguments published as immutable snapshots -- header.
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "arg_parser.hpp"
+
+/**
+ * @brief Single option change between two snapshots.
+ */
+struct arg_change {
+    std::string name;      ///< option name (-s/--long) or positional index (#N)
+    std::string old_value; ///< value in the published snapshot
+    std::string new_value; ///< value in the reloaded arguments
+    bool old_set;          ///< set flag in the published snapshot
+    bool new_set;          ///< set flag in the reloaded arguments
+};
+
+/**
+ * @brief Result of a reload.
+ */
+struct arg_reload_result {
+    bool accepted;                   ///< flag if the new snapshot was published
+    std::string error;               ///< validation error of a rejected reload
+    std::vector<arg_change> changes; ///< differences against the previously published snapshot
+};
+
+/**
+ * @brief Arguments that can be reloaded while other threads read them.
+ *
+ * Every reload loads the arguments from the source into a fresh copy of the prototype parser, so the
+ * usual validation (mandatory options, groups, constraints) runs on the complete new state. Valid state
+ * is frozen and published together with a new generation number, readers always see either the old or
+ * the new snapshot. Invalid state is rejected and the published snapshot stays in place.
+ *
+ * Every reader thread caches the snapshot it got last and only compares the published generation with
+ * it, so reading takes no lock. The published snapshot is fetched under a short lock once per thread
+ * after each accepted reload. A replaced snapshot is destroyed when its last reader drops it.
+ *
+ * Reload is not async-signal-safe. A SIGHUP handler should only set a flag that a regular thread
+ * checks before calling reload.
+ */
+class ArgumentReloader
+{
+public:
+    /**
+     * @brief Source of arguments, the first element is the executable name as in argv.
+     */
+    using source_t = std::function<std::vector<std::string>()>;
+
+    /**
+     * @brief Constructor of the reloader, loads and publishes the initial snapshot.
+     *
+     * Throws std::logic_error if the initial arguments are not valid.
+     *
+     * @param prototype parser with registered options, groups and constraints
+     * @param source function returning the arguments to load
+     */
+    ArgumentReloader(ArgumentParser prototype, source_t source);
+
+    ArgumentReloader(const ArgumentReloader&) = delete;
+    ArgumentReloader& operator=(const ArgumentReloader&) = delete;
+
+    /**
+     * @brief Method for reloading arguments from the source.
+     *
+     * @return result with changes against the published snapshot
+     */
+    arg_reload_result reload();
+
+    /**
+     * @brief Getter for the published snapshot.
+     *
+     * The snapshot stays alive as long as the returned pointer, even when a reload replaces it.
+     * The calling thread keeps a reference to it until it gets a newer snapshot.
+     *
+     * @return currently published snapshot
+     */
+    std::shared_ptr<const ArgumentSnapshot> current() const;
+
+private:
+    const ArgumentParser prototype_;                         ///< registered options
+    const source_t source_;                                  ///< argument source
+    std::shared_ptr<const ArgumentSnapshot> current_;        ///< published snapshot, guarded by publisher_
+    std::atomic<std::uint64_t> generation_;                  ///< generation of the published snapshot
+    mutable std::mutex publisher_;                           ///< guards current_
+    std::mutex writer_;                                      ///< serializes reloads
+
+    std::shared_ptr<const ArgumentSnapshot> load_(std::string& error) const;
+    void publish_(std::shared_ptr<const ArgumentSnapshot> snap);
+};
@@ -0,0 +1,34 @@
+/**
+ * @file arg_alloc.cpp
+ * @brief Counting of heap allocations.
+ * @date 2026-10-18
+ */
+
+#include "arg_alloc.hpp"
+
+namespace {
+
+// innermost counter of the thread, constant initialized
+thread_local arg_alloc_counter* active = nullptr;
+
+}
+
+arg_alloc_counter::arg_alloc_counter() noexcept
+    : stats_{0, 0},
+      prev_(active)
+{
+    active = this;
+}
+
+arg_alloc_counter::~arg_alloc_counter()
+{
+    active = prev_;
+}
+
+void arg_alloc_counter::record(std::size_t bytes) noexcept
+{
+    for (auto C = active; C; C = C->prev_) {
+        C->stats_.allocations++;
+        C->stats_.bytes += bytes;
+    }
+}
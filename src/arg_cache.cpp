@@ -0,0 +1,165 @@
+/**
+ * @file arg_cache.cpp
+ * @brief Cache of loaded command lines.
+ * @date 2026-10-18
+ */
+
+#include <cstring>
+
+#include "arg_cache.hpp"
+
+namespace {
+
+/**
+ * @brief FNV-1a hash of the tokens, including their terminating NULs.
+ */
+std::uint64_t hash_tokens(int argc, char** argv)
+{
+    std::uint64_t h = 14695981039346656037ull;
+
+    for (auto A = 0; A < argc; A++) {
+        auto c = argv[A];
+        do {
+            h = (h ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+        } while (*c++);
+    }
+
+    return h;
+}
+
+bool equals(const std::string& key, int argc, char** argv)
+{
+    std::size_t off = 0;
+
+    for (auto A = 0; A < argc; A++) {
+        const auto len = std::strlen(argv[A]) + 1;
+        if (key.size() - off < len || std::memcmp(key.data() + off, argv[A], len) != 0) {
+            return false;
+        }
+        off += len;
+    }
+
+    return off == key.size();
+}
+
+}
+
+ArgumentCache::ArgumentCache(ArgumentParser prototype, std::size_t capacity)
+    : scratch_(std::move(prototype)),
+      capacity_(capacity ? capacity : 1),
+      entries_(new entry[capacity_])
+{
+    index_.reserve(capacity_);
+}
+
+std::shared_ptr<const ArgumentSnapshot> ArgumentCache::find_(std::uint64_t hash, int argc, char** argv) const
+{
+    const auto it = index_.find(hash);
+
+    if (it == index_.end()) {
+        return nullptr;
+    }
+
+    auto& E = entries_[it->second];
+    if (!equals(E.key, argc, argv)) {
+        return nullptr;
+    }
+
+    E.referenced.store(true, std::memory_order_relaxed);
+    return E.snap;
+}
+
+std::size_t ArgumentCache::victim_()
+{
+    if (used_ < capacity_) {
+        return used_++;
+    }
+
+    // second chance for entries hit since the hand passed them
+    while (entries_[hand_].referenced.exchange(false, std::memory_order_relaxed)) {
+        hand_ = (hand_ + 1) % capacity_;
+    }
+
+    const auto slot = hand_;
+    hand_ = (hand_ + 1) % capacity_;
+
+    index_.erase(entries_[slot].hash);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+
+    return slot;
+}
+
+std::shared_ptr<const ArgumentSnapshot> ArgumentCache::parse(int argc, char** argv)
+{
+    const auto hash = hash_tokens(argc, argv);
+
+    {
+        std::shared_lock<std::shared_timed_mutex> rd(lock_);
+        if (auto snap = find_(hash, argc, argv)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return snap;
+        }
+    }
+
+    std::lock_guard<std::mutex> load(loader_);
+
+    // another thread may have loaded the same command line meanwhile
+    {
+        std::shared_lock<std::shared_timed_mutex> rd(lock_);
+        if (auto snap = find_(hash, argc, argv)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return snap;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    scratch_.reset();
+    scratch_.load_arguments(argc, argv);
+    std::shared_ptr<const ArgumentSnapshot> snap = scratch_.freeze();
+
+    std::string key;
+    for (auto A = 0; A < argc; A++) {
+        key.append(argv[A]).push_back('\0');
+    }
+
+    std::unique_lock<std::shared_timed_mutex> wr(lock_);
+
+    // a different command line with the same hash is replaced in place
+    const auto it = index_.find(hash);
+    const auto slot = it != index_.end() ? it->second : victim_();
+
+    auto& E = entries_[slot];
+    E.hash = hash;
+    E.key = std::move(key);
+    E.snap = snap;
+    E.referenced.store(false, std::memory_order_relaxed);
+    index_[hash] = slot;
+
+    return snap;
+}
+
+arg_cache_stats ArgumentCache::stats() const
+{
+    std::shared_lock<std::shared_timed_mutex> rd(lock_);
+
+    return {hits_.load(std::memory_order_relaxed),
+            misses_.load(std::memory_order_relaxed),
+            evictions_.load(std::memory_order_relaxed),
+            used_};
+}
+
+void ArgumentCache::clear()
+{
+    std::unique_lock<std::shared_timed_mutex> wr(lock_);
+
+    for (auto E = 0u; E < used_; E++) {
+        entries_[E].key.clear();
+        entries_[E].snap.reset();
+        entries_[E].referenced.store(false, std::memory_order_relaxed);
+    }
+
+    index_.clear();
+    used_ = 0;
+    hand_ = 0;
+}
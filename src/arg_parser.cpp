@@ -7,186 +7,1184 @@
 
 
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <sstream>
-#include <iostream>
-#include <iomanip>
+#include <fstream>
+#include <iterator>
+
+#if !defined(_WIN32) && !defined(WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "arg_parser.hpp"
 
+constexpr std::size_t arg_names::npos;
+constexpr std::size_t ArgumentParser::npos;
+constexpr std::size_t ArgumentSnapshot::npos;
+constexpr std::size_t arg_segments::npos;
+constexpr std::uint32_t arg_handle::invalid;
+
+std::uint32_t arg_names::hash_(const char* name, std::size_t len)
+{
+    // FNV-1a
+    std::uint32_t h = 2166136261u;
+
+    for (std::size_t i = 0; i < len; i++) {
+        h ^= static_cast<unsigned char>(name[i]);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+bool arg_names::equals_(std::uint32_t slot, const char* name, std::size_t len) const
+{
+    const auto& ref = refs_[(slot - 1) >> 1];
+    const auto off = (slot - 1) & 1 ? ref.lng_off : ref.shr_off;
+    const auto cnt = (slot - 1) & 1 ? ref.lng_len : ref.shr_len;
+
+    return cnt == len && pool_.compare(off, cnt, name, len) == 0;
+}
+
+void arg_names::insert_(std::uint32_t slot)
+{
+    const auto& ref = refs_[(slot - 1) >> 1];
+    const auto off = (slot - 1) & 1 ? ref.lng_off : ref.shr_off;
+    const auto cnt = (slot - 1) & 1 ? ref.lng_len : ref.shr_len;
+    const auto mask = slots_.size() - 1;
+
+    auto i = hash_(pool_.data() + off, cnt) & mask;
+    while (slots_[i]) {
+        i = (i + 1) & mask;
+    }
+
+    slots_[i] = slot;
+    used_++;
+}
+
+void arg_names::grow_()
+{
+    std::vector<std::uint32_t> old(slots_.empty() ? 16 : slots_.size() * 2, 0);
+    old.swap(slots_);
+    used_ = 0;
+
+    for (auto S : old) {
+        if (S) {
+            insert_(S);
+        }
+    }
+}
+
+std::size_t arg_names::add(const arg_key& ak)
+{
+    if (ak.empty()
+        || (!ak.shr.empty() && find(ak.shr) != npos)
+        || (!ak.lng.empty() && find(ak.lng) != npos)
+        || ak.shr == ak.lng)
+    {
+        return npos;
+    }
+
+    const auto idx = refs_.size();
+    const auto off = static_cast<std::uint32_t>(pool_.size());
+
+    refs_.push_back({off,
+                     static_cast<std::uint32_t>(off + ak.shr.size()),
+                     static_cast<std::uint16_t>(ak.shr.size()),
+                     static_cast<std::uint16_t>(ak.lng.size())});
+    pool_.append(ak.shr).append(ak.lng);
+
+    // keep load factor under 1/2
+    if ((used_ + 2) * 2 > slots_.size()) {
+        grow_();
+    }
+
+    if (!ak.shr.empty()) {
+        insert_(static_cast<std::uint32_t>(idx << 1) + 1);
+    }
+    if (!ak.lng.empty()) {
+        insert_(static_cast<std::uint32_t>(idx << 1 | 1) + 1);
+    }
+
+    return idx;
+}
+
+std::size_t arg_names::find(const char* name, std::size_t len) const
+{
+    if (slots_.empty() || !len) {
+        return npos;
+    }
+
+    const auto mask = slots_.size() - 1;
+
+    for (auto i = hash_(name, len) & mask; slots_[i]; i = (i + 1) & mask) {
+        if (equals_(slots_[i], name, len)) {
+            return (slots_[i] - 1) >> 1;
+        }
+    }
+
+    return npos;
+}
+
+std::size_t arg_names::bytes() const
+{
+    return pool_.capacity() + refs_.capacity() * sizeof(name_ref) + slots_.capacity() * sizeof(std::uint32_t);
+}
+
+std::size_t arg_option_set::add_(const arg_key& ak,
+                                 ArgumentType type,
+                                 const std::string& desc,
+                                 const arg_default& default_value)
+{
+    const auto idx = names_.add(ak);
+
+    if (idx == arg_names::npos) {
+        return arg_names::npos;
+    }
+
+    types_.push_back(type);
+    has_default_.push_back(default_value.first);
+
+    desc_pool_.append(desc);
+    desc_offsets_.push_back(static_cast<std::uint32_t>(desc_pool_.size()));
+    default_pool_.append(default_value.second);
+    default_offsets_.push_back(static_cast<std::uint32_t>(default_pool_.size()));
+
+    return idx;
+}
+
+void arg_option_set::make_mandatory_(std::size_t idx)
+{
+    if (std::find(mandatory_.begin(), mandatory_.end(), idx) == mandatory_.end()) {
+        mandatory_.push_back(idx);
+    }
+}
+
+bool arg_option_set::register_option(const arg_key& ak,
+                                     ArgumentOption opt,
+                                     ArgumentType type,
+                                     const std::string& desc,
+                                     const arg_default& default_value)
+{
+    // sets have no groups to inherit from
+    if (opt == ArgumentOption::INHERIT_GROUP) {
+        return false;
+    }
+
+    const auto idx = add_(ak, type, desc, default_value);
+
+    if (idx == arg_names::npos) {
+        return false;
+    }
+
+    if (opt == ArgumentOption::REQUIRED) {
+        make_mandatory_(idx);
+    }
+
+    return true;
+}
+
+std::size_t arg_option_set::bytes() const
+{
+    return names_.bytes()
+           + types_.capacity() * sizeof(ArgumentType)
+           + has_default_.capacity() * sizeof(std::uint8_t)
+           + desc_pool_.capacity()
+           + desc_offsets_.capacity() * sizeof(std::uint32_t)
+           + default_pool_.capacity()
+           + default_offsets_.capacity() * sizeof(std::uint32_t)
+           + mandatory_.capacity() * sizeof(std::size_t);
+}
+
+std::size_t arg_segments::find(const char* name, std::size_t len) const
+{
+    for (auto&& S : list_) {
+        const auto idx = S.set->names().find(name, len);
+
+        if (idx != npos) {
+            return S.base + idx;
+        }
+    }
+
+    return npos;
+}
+
+bool arg_segments::shadowed(std::size_t id) const
+{
+    const auto ak = key(id);
+
+    return (ak.shr.empty() || find(ak.shr) != id) && (ak.lng.empty() || find(ak.lng) != id);
+}
+
+const arg_option_set& arg_segments::locate(std::size_t id, std::size_t& local) const
+{
+    auto seg = std::upper_bound(list_.begin(),
+                                list_.end(),
+                                id,
+                                [](std::size_t i, const segment& S) { return i < S.base; });
+
+    --seg;
+    local = id - seg->base;
+
+    return *seg->set;
+}
+
+void arg_segments::attach(std::shared_ptr<const arg_option_set> set)
+{
+    const auto base = size();
+
+    list_.push_back({std::move(set), base, false});
+    own_open_ = false;
+}
+
+arg_option_set& arg_segments::own()
+{
+    if (!own_open_) {
+        const auto base = size();
+
+        list_.push_back({std::make_shared<arg_option_set>(), base, true});
+        own_open_ = true;
+    } else if (list_.back().set.use_count() > 1) {
+        // shared with a copy of the parser or a snapshot
+        list_.back().set = std::make_shared<arg_option_set>(*list_.back().set);
+    }
+
+    // owned set is created non-const by the code above
+    return const_cast<arg_option_set&>(*list_.back().set);
+}
+
+std::size_t arg_segments::bytes(bool shared) const
+{
+    std::size_t ret = list_.capacity() * sizeof(segment);
+
+    for (auto&& S : list_) {
+        if (S.owned != shared) {
+            ret += S.set->bytes();
+        }
+    }
+
+    return shared ? ret - list_.capacity() * sizeof(segment) : ret;
+}
+
+namespace {
+
+bool matches_pattern(const std::string& value, ArgumentPattern pattern)
+{
+    const auto is_digit = [](unsigned char c) { return c >= '0' && c <= '9'; };
+    const auto is_alpha = [](unsigned char c) { return (c | 0x20) >= 'a' && (c | 0x20) <= 'z'; };
+
+    switch (pattern) {
+        case ArgumentPattern::DIGITS:
+            return !value.empty()
+                   && std::all_of(value.begin(), value.end(), [&](unsigned char c) { return is_digit(c); });
+        case ArgumentPattern::ALNUM:
+            return !value.empty()
+                   && std::all_of(value.begin(), value.end(),
+                                  [&](unsigned char c) { return is_digit(c) || is_alpha(c); });
+        case ArgumentPattern::IDENTIFIER:
+            return !value.empty()
+                   && !is_digit(static_cast<unsigned char>(value[0]))
+                   && std::all_of(value.begin(), value.end(),
+                                  [&](unsigned char c) { return is_digit(c) || is_alpha(c) || c == '_'; });
+        case ArgumentPattern::HOSTNAME:
+            return !value.empty()
+                   && std::all_of(value.begin(), value.end(),
+                                  [&](unsigned char c) { return is_digit(c) || is_alpha(c) || c == '.' || c == '-'; });
+        default:
+            return true;
+    }
+}
+
+const char* pattern_name(ArgumentPattern pattern)
+{
+    switch (pattern) {
+        case ArgumentPattern::DIGITS:
+            return "digits";
+        case ArgumentPattern::ALNUM:
+            return "letters and digits";
+        case ArgumentPattern::IDENTIFIER:
+            return "an identifier";
+        case ArgumentPattern::HOSTNAME:
+            return "a host name";
+        default:
+            return "anything";
+    }
+}
+
+// truncation of a FLT value, out of range values saturate and NaN reads as 0
+std::int64_t truncate_flt(double val)
+{
+    // 2^63, the smallest double above the int64 range
+    const double limit = 9223372036854775808.0;
+
+    if (std::isnan(val)) {
+        return 0;
+    }
+    if (val >= limit) {
+        return std::numeric_limits<std::int64_t>::max();
+    }
+    if (val < -limit) {
+        return std::numeric_limits<std::int64_t>::min();
+    }
+
+    return static_cast<std::int64_t>(val);
+}
+
+// binary snapshot layout:
+//   header   "CAPS", u16 version, u16 reserved, u32 options, u32 positionals
+//   exe      u32 length, bytes
+//   option   u8 type, u8 set, u16 short length, u16 long length, u32 value length, names and value bytes
+//   position u32 length, bytes
+const char SNAPSHOT_MAGIC[4] = {'C', 'A', 'P', 'S'};
+const std::uint16_t SNAPSHOT_VERSION = 2;
+
+// smallest records, used to bound the counts of a snapshot
+const std::uint64_t SNAPSHOT_OPTION_MIN = 2 * sizeof(std::uint8_t) + 2 * sizeof(std::uint16_t) + sizeof(std::uint32_t);
+const std::uint64_t SNAPSHOT_POSITIONAL_MIN = sizeof(std::uint32_t);
+
+/**
+ * @brief Option record of a snapshot, decoded before it is applied.
+ */
+struct snapshot_option
+{
+    std::uint8_t type;
+    std::uint8_t is_set;
+    arg_key key;
+    const char* val;
+    std::uint32_t val_len;
+    std::size_t id;
+};
+
+template<typename T> void put(std::string& buf, T val)
+{
+    buf.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+struct snapshot_reader
+{
+    const char* cur;
+    const char* end;
+
+    template<typename T> T get()
+    {
+        T val;
+        std::memcpy(&val, bytes(sizeof(T)), sizeof(T));
+        return val;
+    }
+
+    const char* bytes(std::size_t n)
+    {
+        if (static_cast<std::size_t>(end - cur) < n) {
+            throw std::logic_error("Truncated argument snapshot.");
+        }
+
+        const auto ret = cur;
+        cur += n;
+        return ret;
+    }
+};
+
+}
+
+std::string arg_constraint::check(const std::string& value, ArgumentType type) const
+{
+    if (!matches_pattern(value, pattern)) {
+        return "'" + value + "' must be " + pattern_name(pattern);
+    }
+
+    if (!choices.empty() && !std::binary_search(choices.begin(), choices.end(), value)) {
+        return "'" + value + "' is not one of the allowed choices";
+    }
+
+    if (has_range) {
+        char* end = nullptr;
+
+        errno = 0;
+        const auto num = type == ArgumentType::FLT
+                         ? std::strtod(value.c_str(), &end)
+                         : static_cast<double>(std::strtoll(value.c_str(), &end, type == ArgumentType::HEX ? 16 : 10));
+
+        if (value.empty() || *end != '\0' || errno == ERANGE) {
+            return "'" + value + "' is not a valid number";
+        }
+
+        if (num < min || num > max) {
+            std::ostringstream ss;
+            ss << "'" << value << "' is out of range <" << min << ", " << max << ">";
+            return ss.str();
+        }
+    }
+
+    return "";
+}
+
+arg_mapping::arg_mapping(std::string path)
+    : path_(std::move(path))
+{
+#if defined(_WIN32) || defined(WIN32)
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) {
+        throw std::logic_error("Cannot open file: " + path_);
+    }
+
+    copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = copy_.data();
+    size_ = copy_.size();
+#else
+    const auto fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::logic_error("Cannot open file: " + path_);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        throw std::logic_error("Not a regular file: " + path_);
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    // empty files cannot be mapped
+    if (size_) {
+        const auto addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::logic_error("Cannot map file: " + path_);
+        }
+        data_ = static_cast<const unsigned char*>(addr);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+#endif
+}
+
+arg_mapping::~arg_mapping()
+{
+#if !defined(_WIN32) && !defined(WIN32)
+    if (data_) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+#endif
+}
+
+namespace {
+
+/**
+ * @brief Help option shared by all parsers, created on first use.
+ */
+const std::shared_ptr<const arg_option_set>& help_options()
+{
+    static const std::shared_ptr<const arg_option_set> help = [] {
+        auto set = std::make_shared<arg_option_set>();
+        set->register_option({"h", "help"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "Show help text and exit");
+        return set;
+    }();
+
+    return help;
+}
+
+}
+
 ArgumentParser::ArgumentParser(const std::string& desc, const std::string& usage)
 	: OPT_WIDTH_(25),
       exec_name_(),
-      options_(),
-      mandatory_(),
       prog_desc_(desc),
       usage_(usage)
 {
-	// automatically register help option
-	this->register_option({"h", "help"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "Show help text and exit");
+	// automatically register help option, the set is shared so nothing is copied
+	segments_.attach(help_options());
+}
+
+arg_handle ArgumentParser::register_option(const arg_key& ak,
+                                           ArgumentOption opt,
+                                           ArgumentType type,
+                                           const std::string& desc,
+                                           const std::string& excl_group,
+                                           const arg_default& default_value)
+{
+    // empty key is not valid
+	if (ak.empty()) {
+        return arg_handle();
+    }
+
+    // cannot inherit property from no group
+    if (opt == ArgumentOption::INHERIT_GROUP && excl_group.empty()) {
+        return arg_handle();
+    }
+
+    // cannot add option to non-existent group
+    if (!excl_group.empty() && (mtx_groups_.find(excl_group) == mtx_groups_.end())) {
+        return arg_handle();
+    }
+
+    // names must be unique across attached sets too
+    if ((!ak.shr.empty() && find_option_(ak.shr) != npos) || (!ak.lng.empty() && find_option_(ak.lng) != npos)) {
+        return arg_handle();
+    }
+
+    // store option
+    materialize_();
+
+    auto&& own = segments_.own();
+    const auto idx = own.add_(ak, type, desc, default_value);
+
+    // option was not added
+	if (idx == npos) {
+		return arg_handle();
+	}
+
+    const auto id = segments_.size() - 1;
+
+    values_.push_back(default_value.second);
+    types_.push_back(type);
+    set_.push_back(default_value.first);
+    constraint_idx_.push_back(0);
+
+    // mark option as mandatory if explicitly stated
+	if (opt == ArgumentOption::REQUIRED) {
+		own.make_mandatory_(idx);
+	}
+
+    // store option into group
+	if (!excl_group.empty()) {
+
+        auto&& grp = mtx_groups_.at(excl_group);
+
+        // mandatory option turns the group mandatory
+        if (opt == ArgumentOption::REQUIRED) {
+            grp.make_mandatory();
+        }
+
+        // make option mandatory if group is mandatory
+        if (grp.mandatory() || (opt == ArgumentOption::INHERIT_GROUP && grp.mandatory())) {
+            own.make_mandatory_(idx);
+        }
+
+        grp.push_back(id);
+	}
+
+    // option is registered
+	return {static_cast<std::uint32_t>(id), type};
+}
+
+void ArgumentParser::materialize_()
+{
+    const auto total = segments_.size();
+
+    values_.reserve(total);
+    types_.reserve(total);
+    set_.reserve(total);
+    constraint_idx_.reserve(total);
+
+    for (auto id = values_.size(); id < total; id++) {
+        std::size_t local;
+        const auto& S = segments_.locate(id, local);
+
+        values_.emplace_back();
+        S.assign_default(local, values_.back());
+        types_.push_back(S.type(local));
+        set_.push_back(S.has_default(local));
+        constraint_idx_.push_back(0);
+    }
+}
+
+arg_constraint* ArgumentParser::constraint_(const std::string& key)
+{
+    materialize_();
+
+    const auto id = find_option_(key);
+
+    if (id == npos || types_[id] == ArgumentType::BOOL) {
+        return nullptr;
+    }
+
+    if (!constraint_idx_[id]) {
+        constraints_.emplace_back();
+        constraint_idx_[id] = static_cast<std::uint32_t>(constraints_.size());
+    }
+
+    return &constraints_[constraint_idx_[id] - 1];
+}
+
+bool ArgumentParser::add_choices(const std::string& key, std::vector<std::string> choices)
+{
+    auto c = constraint_(key);
+
+    if (!c) {
+        return false;
+    }
+
+    std::sort(choices.begin(), choices.end());
+    choices.erase(std::unique(choices.begin(), choices.end()), choices.end());
+    c->choices = std::move(choices);
+
+    return true;
+}
+
+bool ArgumentParser::add_range(const std::string& key, double min, double max)
+{
+    const auto id = find_option_(key);
+
+    if (id == npos || type_(id) == ArgumentType::STR || type_(id) == ArgumentType::FILE || min > max) {
+        return false;
+    }
+
+    auto c = constraint_(key);
+
+    if (!c) {
+        return false;
+    }
+
+    c->has_range = true;
+    c->min = min;
+    c->max = max;
+
+    return true;
+}
+
+bool ArgumentParser::add_pattern(const std::string& key, ArgumentPattern pattern)
+{
+    auto c = constraint_(key);
+
+    if (!c) {
+        return false;
+    }
+
+    c->pattern = pattern;
+
+    return true;
+}
+
+std::size_t ArgumentParser::register_options(const arg_spec* specs, std::size_t count)
+{
+    materialize_();
+
+    const auto total = values_.size() + count;
+    values_.reserve(total);
+    types_.reserve(total);
+    set_.reserve(total);
+    constraint_idx_.reserve(total);
+
+    std::size_t registered = 0;
+
+    for (auto S = specs; S != specs + count; S++) {
+        const auto def = S->default_value ? arg_default(S->default_value) : arg_default();
+
+        if (register_option({S->shr, S->lng}, S->opt, S->type, S->desc, S->group, def)) {
+            registered++;
+        }
+    }
+
+    return registered;
+}
+
+void ArgumentParser::register_positional(unsigned int count, std::vector<std::string> names)
+{
+	for (auto i = 0u; i < count; i++) {
+		if (i < names.size()) {
+			positional_.emplace_back("", names[i]);
+		} else {
+			positional_.emplace_back("", "ARG_" + std::to_string(i + 1));
+		}
+	}
+}
+
+std::string ArgumentParser::option_name_(std::size_t id) const
+{
+    const auto ak = segments_.key(id);
+
+    return (ak.shr.empty() ? "-" : "-" + ak.shr) + "/" + (ak.lng.empty() ? "-" : "--" + ak.lng);
+}
+
+decltype(auto) ArgumentParser::check_mandatory_options_() {
+    std::vector<std::size_t> missing;
+
+
+    segments_.for_each_mandatory([this, &missing](std::size_t M)
+    {
+        if (!set_[M] && !option_is_mutually_exclusive_(M)) {
+            missing.emplace_back(M);
+        }
+    });
+
+    return missing;
+}
+
+decltype(auto) ArgumentParser::check_mandatory_option_groups_() {
+    std::vector<std::reference_wrapper<const std::string>> missing;
+
+    for (auto& G : mtx_groups_) {
+        if (G.second.mandatory()) {
+            if (std::all_of(G.second.begin(), G.second.end(),
+                            [this](auto id) -> bool { return !set_[id]; })) {
+                missing.emplace_back(G.first);
+            }
+        }
+    }
+
+    return missing;
+}
+
+decltype(auto) ArgumentParser::check_option_conflicts_() {
+    std::vector<std::reference_wrapper<const std::string>> conflicts;
+
+    for (auto& G : mtx_groups_) {
+        if (std::count_if(G.second.begin(), G.second.end(), [this](auto id) { return set_[id] != 0; }) > 1) {
+            conflicts.emplace_back(G.first);
+        }
+    }
+
+    return conflicts;
+}
+
+void ArgumentParser::set_exec_name_(const char* path, std::size_t len)
+{
+    auto name = path + len;
+
+#if defined(_WIN32) || defined(WIN32)
+    while (name != path && name[-1] != '\\') {
+#else
+    while (name != path && name[-1] != '/') {
+#endif
+        name--;
+    }
+
+    exec_name_.assign(name, path + len);
+}
+
+void ArgumentParser::set_value_(std::size_t id, const char* val, std::size_t len, std::string& invalid)
+{
+    values_[id].assign(val, len);
+
+    if (constraint_idx_[id]) {
+        const auto err = constraints_[constraint_idx_[id] - 1].check(values_[id], types_[id]);
+        if (!err.empty()) {
+            invalid.append(option_name_(id) + ": " + err + "\n");
+        }
+    }
+}
+
+bool ArgumentParser::is_negative_number_(std::size_t id, const char* tok, std::size_t len) const
+{
+    if (len < 2 || tok[0] != '-') {
+        return false;
+    }
+
+    switch (types_[id]) {
+        case ArgumentType::INT:
+            return std::all_of(tok + 1, tok + len, [](char c) { return c >= '0' && c <= '9'; });
+        case ArgumentType::HEX:
+            // digit first, so short options named by hex letters (-f, -abc) are not taken for values
+            return tok[1] >= '0' && tok[1] <= '9'
+                   && std::all_of(tok + 2, tok + len, [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) || c == 'x' || c == 'X'; });
+        case ArgumentType::FLT:
+            return (tok[1] >= '0' && tok[1] <= '9') || (tok[1] == '.' && len > 2 && tok[2] >= '0' && tok[2] <= '9');
+        default:
+            return false;
+    }
+}
+
+namespace {
+
+/**
+ * @brief Length of a NUL-terminated token, scanning stops one byte past the limit.
+ */
+std::size_t token_length(const char* tok, std::size_t max_len)
+{
+    return max_len == arg_limits::unlimited ? std::strlen(tok) : strnlen(tok, max_len + 1);
+}
+
+/**
+ * @brief Tokens of an argv array.
+ */
+struct argv_tokens
+{
+    char** cur;
+    char** end;
+    std::size_t max_len;
+
+    bool next(const char*& tok, std::size_t& len)
+    {
+        if (cur == end) {
+            return false;
+        }
+
+        tok = *cur++;
+        len = token_length(tok, max_len);
+        return true;
+    }
+};
+
+/**
+ * @brief Tokens of a NUL-delimited buffer.
+ */
+struct cmdline_tokens
+{
+    const char* cur;
+    const char* end;
+    bool more;
+
+    bool next(const char*& tok, std::size_t& len)
+    {
+        if (!more) {
+            return false;
+        }
+
+        const auto nul = static_cast<const char*>(std::memchr(cur, '\0', static_cast<std::size_t>(end - cur)));
+
+        tok = cur;
+        if (nul) {
+            len = static_cast<std::size_t>(nul - cur);
+            cur = nul + 1;
+        } else {
+            len = static_cast<std::size_t>(end - cur);
+            more = false;
+        }
+        return true;
+    }
+};
+
+}
+
+void ArgumentParser::mark_given_(std::size_t id, std::size_t tok)
+{
+    set_[id] = IS_GIVEN;
+
+    if (!occurrences_.empty() && ++occurrences_[id] > limits_.max_list_elements) {
+        throw ArgumentError(ArgumentErrorCode::TOO_MANY_ELEMENTS,
+                            "Option given too many times: " + option_name_(id), tok, limits_.max_list_elements);
+    }
+}
+
+bool ArgumentParser::is_bundle_(const char* name, std::size_t len) const
+{
+    for (auto c = name; c != name + len; c++) {
+        const auto id = segments_.find(c, 1);
+        if (id == npos) {
+            return false;
+        }
+        // the rest of the token is the value
+        if (types_[id] != ArgumentType::BOOL) {
+            return true;
+        }
+    }
+
+    return true;
+}
+
+void ArgumentParser::forward_(std::size_t idx, const char* tok)
+{
+    forwarded_.push_back(idx);
+    forward_argv_.push_back(const_cast<char*>(tok));
 }
 
-bool ArgumentParser::register_option(const arg_key& ak,
-                                     ArgumentOption opt,
-                                     ArgumentType type,
-                                     const std::string& desc,
-									 const std::string& excl_group,
-                                     const arg_default& default_value)
+template<typename Tokens> void ArgumentParser::load_tokens_(Tokens& tokens, std::size_t total)
 {
-    // empty key is not valid
-	if (ak.empty()) {
-        return false;
-    }
+    // tokenizer states
+    enum class state {
+        OPTIONS,    // options and positionals
+        VALUE,      // value of the previous option expected
+        POSITIONAL  // only positionals after "--"
+    };
 
-    // cannot inherit property from no group
-    if (opt == ArgumentOption::INHERIT_GROUP && excl_group.empty()) {
-        return false;
+    materialize_();
+
+    if (limits_.max_list_elements != arg_limits::unlimited) {
+        occurrences_.assign(values_.size(), 0);
+    } else {
+        occurrences_.clear();
     }
 
-    // store option
-	auto ret = options_.emplace(ak, arg_opt(default_value.second, type, desc, default_value.first));
+    forwarded_.clear();
+    forward_argv_.clear();
 
-    // option was not added
-	if (!ret.second) {
-		return false;
-	}
+    auto st = state::OPTIONS;
+    auto opt = npos;
+    std::size_t pos = 0;
+    std::size_t idx = 0;
+    std::string invalid;
 
-    // mark option as mandatory if explicitly stated
-	if (opt == ArgumentOption::REQUIRED) {
-		make_option_mandatory_(ak);
-	}
+    const char* tok;
+    std::size_t len;
 
-    // store option into group
-	if (!excl_group.empty() && (mtx_groups_.find(excl_group) != mtx_groups_.end())) {
+    while (tokens.next(tok, len)) {
+        // limits are checked before the token is used
+        if (++idx > limits_.max_tokens) {
+            throw ArgumentError(ArgumentErrorCode::TOO_MANY_TOKENS, "Too many arguments.", idx, limits_.max_tokens);
+        }
+        if (len > limits_.max_token_bytes) {
+            throw ArgumentError(ArgumentErrorCode::TOKEN_TOO_LONG,
+                                "Argument " + std::to_string(idx) + " is too long.", idx, limits_.max_token_bytes);
+        }
+        total += len + 1;
+        if (total > limits_.max_total_bytes) {
+            throw ArgumentError(ArgumentErrorCode::INPUT_TOO_LONG, "Command line is too long.", idx, limits_.max_total_bytes);
+        }
 
-        auto&& grp = mtx_groups_.at(excl_group);
+        const bool dash = len > 1 && tok[0] == '-';
 
-        // mandatory option turns the group mandatory
-        if (opt == ArgumentOption::REQUIRED) {
-            grp.make_mandatory();
+        if (st == state::VALUE) {
+            // option-like token ends the value unless it is a negative number for numeric option
+            if (!dash || is_negative_number_(opt, tok, len)) {
+                set_value_(opt, tok, len, invalid);
+                st = state::OPTIONS;
+                continue;
+            }
+            invalid.append(option_name_(opt) + ": missing value\n");
+            st = state::OPTIONS;
         }
 
-        // make option mandatory if group is mandatory
-        if (grp.mandatory() || (opt == ArgumentOption::INHERIT_GROUP && grp.mandatory())) {
-            make_option_mandatory_(ak);
+        if (st == state::POSITIONAL && pass_through_) {
+            forward_(idx, tok);
+            continue;
         }
 
-		return insert_into_group(excl_group, ak);
-	} else if (!excl_group.empty() && (mtx_groups_.find(excl_group) == mtx_groups_.end())) {
-        // cannot add option to non-existent group
-        return false;
+        if (st == state::POSITIONAL || !dash) {
+            if (pos >= positional_.size() && pass_through_) {
+                forward_(idx, tok);
+                continue;
+            }
+            if (pos >= positional_.size()) {
+                throw ArgumentError(ArgumentErrorCode::TOO_MANY_POSITIONALS,
+                                    "Too many positional arguments: " + std::string(tok, len), idx);
+            }
+            positional_[pos++].value.assign(tok, len);
+            continue;
+        }
+
+        // "--" ends options
+        if (len == 2 && tok[1] == '-') {
+            st = state::POSITIONAL;
+            continue;
+        }
+
+        // in pass-through mode unknown options after positionals are forwarded, known ones are checked below
+        if (pos && !pass_through_) {
+            throw ArgumentError(ArgumentErrorCode::POSITIONAL_ORDER, "Positional arguments cannot precede options.", idx);
+        }
+
+        const auto name = tok + (tok[1] == '-' ? 2 : 1);
+        const auto name_len = static_cast<std::size_t>(tok + len - name);
+
+        // --key=value, memchr is vectorized by the C library
+        const auto eq = static_cast<const char*>(std::memchr(name, '=', name_len));
+        if (eq) {
+            opt = segments_.find(name, static_cast<std::size_t>(eq - name));
+            if (opt == npos && pass_through_) {
+                forward_(idx, tok);
+                continue;
+            }
+            if (opt == npos) {
+                throw ArgumentError(ArgumentErrorCode::UNKNOWN_OPTION, "Unknown option: " + std::string(tok, len), idx);
+            }
+            if (pos) {
+                throw ArgumentError(ArgumentErrorCode::POSITIONAL_ORDER, "Positional arguments cannot precede options.", idx);
+            }
+
+            mark_given_(opt, idx);
+            if (types_[opt] == ArgumentType::BOOL) {
+                invalid.append(option_name_(opt) + ": does not take a value\n");
+            } else {
+                set_value_(opt, eq + 1, static_cast<std::size_t>(tok + len - eq - 1), invalid);
+            }
+            continue;
+        }
+
+        opt = segments_.find(name, name_len);
+        if (opt != npos) {
+            if (pos) {
+                throw ArgumentError(ArgumentErrorCode::POSITIONAL_ORDER, "Positional arguments cannot precede options.", idx);
+            }
+            mark_given_(opt, idx);
+            if (types_[opt] != ArgumentType::BOOL) {
+                st = state::VALUE;
+            }
+            continue;
+        }
+
+        // bundled short options -abc or short option with attached value -kVALUE
+        if (name == tok + 1 && pass_through_ && !is_bundle_(name, static_cast<std::size_t>(tok + len - name))) {
+            forward_(idx, tok);
+            continue;
+        }
+
+        if (name == tok + 1) {
+            if (pos) {
+                throw ArgumentError(ArgumentErrorCode::POSITIONAL_ORDER, "Positional arguments cannot precede options.", idx);
+            }
+            for (auto c = name; c != tok + len; c++) {
+                opt = segments_.find(c, 1);
+                if (opt == npos) {
+                    throw ArgumentError(ArgumentErrorCode::UNKNOWN_OPTION, "Unknown option: " + std::string(tok, len), idx);
+                }
+
+                mark_given_(opt, idx);
+                if (types_[opt] != ArgumentType::BOOL) {
+                    if (c + 1 != tok + len) {
+                        set_value_(opt, c + 1, static_cast<std::size_t>(tok + len - c - 1), invalid);
+                    } else {
+                        st = state::VALUE;
+                    }
+                    break;
+                }
+            }
+            continue;
+        }
+
+        if (pass_through_) {
+            forward_(idx, tok);
+            continue;
+        }
+
+        throw ArgumentError(ArgumentErrorCode::UNKNOWN_OPTION, "Unknown option: " + std::string(tok, len), idx);
     }
 
-    // option is registered
-	return true;
+    if (st == state::VALUE) {
+        invalid.append(option_name_(opt) + ": missing value\n");
+    }
+
+    if (pass_through_) {
+        forward_argv_.push_back(nullptr);
+    }
+
+    check_loaded_arguments_(pos, invalid);
 }
 
-void ArgumentParser::register_positional(unsigned int count, std::vector<std::string> names)
+void ArgumentParser::load_arguments(int argc, char **argv)
 {
-	for (auto i = 0u; i < count; i++) {
-		if (i < names.size()) {
-			positional_.emplace_back("", names[i]);
-		} else {
-			positional_.emplace_back("", "ARG_" + std::to_string(i + 1));
-		}
-	}
-}
+    if (argc > 0 && static_cast<std::size_t>(argc - 1) > limits_.max_tokens) {
+        throw ArgumentError(ArgumentErrorCode::TOO_MANY_TOKENS, "Too many arguments.",
+                            limits_.max_tokens + 1, limits_.max_tokens);
+    }
 
-decltype(auto) ArgumentParser::check_mandatory_options_() {
-    std::vector<std::reference_wrapper<const arg_key>> missing;
+    const auto exe_len = token_length(argv[0], limits_.max_token_bytes);
+    if (exe_len > limits_.max_token_bytes) {
+        throw ArgumentError(ArgumentErrorCode::TOKEN_TOO_LONG, "Executable name is too long.", 0, limits_.max_token_bytes);
+    }
 
+    set_exec_name_(argv[0], exe_len);
 
-    for (auto& M : mandatory_) {
-        if (!option_is_mutually_exclusive_(M) && !options_.at(M).is_set) {
-            missing.emplace_back(M);
-        }
+    // forwarded arguments fit without growing the lists
+    if (pass_through_) {
+        forwarded_.reserve(static_cast<std::size_t>(argc));
+        forward_argv_.reserve(static_cast<std::size_t>(argc) + 1);
     }
 
-    return missing;
+    argv_tokens tokens{argv + 1, argv + argc, limits_.max_token_bytes};
+    load_tokens_(tokens, exe_len + 1);
 }
 
-decltype(auto) ArgumentParser::check_mandatory_option_groups_() {
-    std::vector<std::reference_wrapper<const std::string>> missing;
+void ArgumentParser::load_cmdline(const char* buf, std::size_t len)
+{
+    const bool terminated = len && buf[len - 1] == '\0';
 
-    for (auto& G : mtx_groups_) {
-        if (G.second.mandatory()) {
-            if (std::all_of(G.second.begin(), G.second.end(),
-                            [this](auto &opt) -> bool { return !options_.at(opt).is_set; })) {
-                missing.emplace_back(G.first);
-            }
-        }
+    // terminating NUL does not start another token
+    if (terminated) {
+        len--;
     }
 
-    return missing;
-}
+    // the buffer holds the whole command line, so oversized input is rejected before it is read
+    if (len + 1 > limits_.max_total_bytes) {
+        throw ArgumentError(ArgumentErrorCode::INPUT_TOO_LONG, "Command line is too long.",
+                            ArgumentError::no_token, limits_.max_total_bytes);
+    }
 
-decltype(auto) ArgumentParser::check_option_conflicts_() {
-    std::vector<std::reference_wrapper<const std::string>> conflicts;
+    const auto end = buf + len;
+    auto exe = static_cast<const char*>(std::memchr(buf, '\0', len));
 
-    for (auto& G : mtx_groups_) {
-        if (std::count_if(G.second.begin(), G.second.end(), [this](auto& ak) {return options_.at(ak).is_set; }) > 1) {
-            conflicts.emplace_back(G.first);
+    if (!exe) {
+        exe = end;
+    }
+
+    const auto exe_len = static_cast<std::size_t>(exe - buf);
+    if (exe_len > limits_.max_token_bytes) {
+        throw ArgumentError(ArgumentErrorCode::TOKEN_TOO_LONG, "Executable name is too long.", 0, limits_.max_token_bytes);
+    }
+
+    if (pass_through_ && exe != end) {
+        // forwarded arguments are handed out as C strings, the last one needs its NUL
+        if (!terminated) {
+            throw ArgumentError(ArgumentErrorCode::INVALID_ARGUMENTS,
+                                "Forwarded command line must be NUL-terminated.", ArgumentError::no_token);
+        }
+
+        // forwarded arguments fit without growing the lists
+        std::size_t count = 2;
+        for (auto c = exe + 1; (c = static_cast<const char*>(std::memchr(c, '\0', static_cast<std::size_t>(end - c)))); c++) {
+            count++;
         }
+        forwarded_.reserve(count);
+        forward_argv_.reserve(count + 1);
     }
 
-    return conflicts;
+    set_exec_name_(buf, exe_len);
+
+    cmdline_tokens tokens{exe == end ? end : exe + 1, end, exe != end};
+    load_tokens_(tokens, exe_len + 1);
 }
 
-void ArgumentParser::load_arguments(int argc, char **argv)
+arg_bytes ArgumentParser::file_bytes(const std::string& key) const
 {
-	std::vector<std::string> args;
-	size_t pos = 0;
+    const auto id = find_option_(key);
 
-	//store executable name
-	std::string exe(argv[0]);
-#if defined(_WIN32) || defined(WIN32)
-	pos = exe.find_last_of('\\');
-#else
-	pos = exe.find_last_of('/');
-#endif
+    if (id == npos || type_(id) != ArgumentType::FILE) {
+        throw std::logic_error("Not a file option: " + key);
+    }
 
-	if (pos != std::string::npos) {
-		exe = exe.substr(pos + 1);
-	}
+    if (!is_set_(id)) {
+        return {nullptr, 0};
+    }
 
-	pos = 0;
+    const auto path = value_(id);
+    auto M = std::find_if(mappings_.begin(), mappings_.end(), [id](auto& m) { return m.first == id; });
+
+    // the option may have been loaded again with a different path
+    if (M == mappings_.end() || M->second->path() != path) {
+        auto mapping = std::make_shared<const arg_mapping>(path);
+        if (M == mappings_.end()) {
+            mappings_.emplace_back(id, std::move(mapping));
+            M = mappings_.end() - 1;
+        } else {
+            M->second = std::move(mapping);
+        }
+    }
 
-	exec_name_ = exe;
+    return M->second->bytes();
+}
 
+void ArgumentParser::reset()
+{
+    materialize_();
 
-	for (auto i = 1; i < argc; i++) {
-		args.emplace_back(std::string(argv[i]));
-	}
+    for (auto O = 0u; O < values_.size(); O++) {
+        std::size_t local;
+        const auto& S = segments_.locate(O, local);
 
-	auto&& opt = options_.end();
-
-	for (auto&& A : args) {
-		if ((A[0] == '-' || A.substr(0, 2) == "--") && !pos) {
-			auto opt_key = A.substr(A.find_first_not_of('-'));
-			opt = std::find_if(options_.begin(),
-			                   options_.end(),
-			                   [opt_key](const auto& a)
-			                   { return a.first.shr == opt_key || a.first.lng == opt_key; });
-
-			if (opt != options_.end())
-				opt->second.is_set = true;
-
-			if (opt->second.type == ArgumentType::BOOL)
-				opt = options_.end();
-		} else if (!(A[0] == '-' || A.substr(0, 2) == "--")) {
-			if (opt != options_.end()) {
-				opt->second.value = A;
-				opt = options_.end();
-			} else {
-				if (positional_.capacity()) {
-					positional_[pos++].value = A;
-				}
-			}
-		} else {
-			throw std::logic_error("Positional arguments cannot precede options.");
-		}
-	}
+        S.assign_default(local, values_[O]);
+        set_[O] = S.has_default(local) ? IS_SET : 0;
+    }
+
+    for (auto&& P : positional_) {
+        P.value.clear();
+    }
+
+    mappings_.clear();
+    forwarded_.clear();
+    forward_argv_.clear();
+}
 
+void ArgumentParser::check_loaded_arguments_(std::size_t pos, const std::string& invalid)
+{
 	// check for help and return if specified
 	if (!option_is_set("help")) {
         // check for missing mandatory options (exclude mtx)
@@ -198,11 +1196,8 @@ void ArgumentParser::load_arguments(int argc, char **argv)
 
 		if (!missing_args.empty()) {
             std::string req_options("Missing required options:\n");
-            for (auto &&M : missing_args) {
-                req_options.append((M.get().shr.empty() ? "-" : "-" + M.get().shr)
-                                   + "/"
-                                   + (M.get().lng.empty() ? "-" : "--" + M.get().lng)
-                                   + "\n");
+            for (auto M : missing_args) {
+                req_options.append(option_name_(M) + "\n");
             }
             err_str += req_options;
         }
@@ -211,152 +1206,452 @@ void ArgumentParser::load_arguments(int argc, char **argv)
             std::string req_groups("At least one option from these groups must be set:\n");
             for (auto&& G : missing_grp) {
                 req_groups.append(G.get() + "\n");
-                for (auto&& O : mtx_groups_.at(G)) {
-                    req_groups.append("\t"
-                                      + (O.shr.empty() ? "-" : "-" + O.shr)
-                                      + "/"
-                                      + (O.lng.empty() ? "-" : "--" + O.lng)
-                                      + "\n");
+                for (auto O : mtx_groups_.at(G)) {
+                    req_groups.append("\t" + option_name_(O) + "\n");
                 }
             }
             err_str += req_groups;
 		}
+
+        if (!invalid.empty()) {
+            err_str += "Invalid option values:\n" + invalid;
+        }
+
         if (!err_str.empty()) {
-            throw std::logic_error(err_str);
+            throw ArgumentError(ArgumentErrorCode::INVALID_ARGUMENTS, err_str);
         }
 
         if (!conflicting_opts.empty()) {
             std::string X_groups("Conflicting options used in these groups:\n");
             for (auto&& G : conflicting_opts) {
                 X_groups.append(G.get() + "\n");
-                for (auto&& O : mtx_groups_.at(G)) {
-                    if (option_is_set(O)) {
-                        X_groups.append("\t"
-                                        + (O.shr.empty() ? "-" : "-" + O.shr)
-                                        + "/"
-                                        + (O.lng.empty() ? "-" : "--" + O.lng)
-                                        + "\n");
+                for (auto O : mtx_groups_.at(G)) {
+                    if (set_[O]) {
+                        X_groups.append("\t" + option_name_(O) + "\n");
                     }
                 }
             }
-            throw std::logic_error(X_groups);
+            throw ArgumentError(ArgumentErrorCode::INVALID_ARGUMENTS, X_groups);
         }
 
 		if (pos < (static_cast<size_t>(positional_.size()))) {
-			throw std::logic_error("Missing positional arguments. Check program usage ");
+			throw ArgumentError(ArgumentErrorCode::INVALID_ARGUMENTS, "Missing positional arguments. Check program usage ");
 		}
 	}
 }
 
-void ArgumentParser::print_usage_text()
+std::shared_ptr<const ArgumentSnapshot> ArgumentParser::freeze() const
 {
-    auto req = static_cast<std::string>("");
-    auto opt = static_cast<std::string>("");
+    // constructor is private, make_shared cannot be used
+    std::shared_ptr<ArgumentSnapshot> snap(new ArgumentSnapshot());
 
-    std::cout << "Usage: ";
+    const auto options = segments_.size();
 
-    std::cout << exec_name_ << " ";
+    snap->segments_ = segments_;
+    snap->strings_ = values_;
+    snap->exec_name_ = exec_name_;
+    snap->entries_.reserve(options);
 
-    if (!usage_.empty()) {
-        std::cout << usage_ << std::endl;
-    } else {
-        for (auto&& O : options_) {
-            auto arg = static_cast<std::string>("");
+    for (auto O = snap->strings_.size(); O < options; O++) {
+        snap->strings_.push_back(value_(O));
+    }
 
-            if (O.first.shr == "h" || O.first.lng == "help") {
-                //
-                continue;
-            }
+    for (auto O = 0u; O < options; O++) {
+        ArgumentSnapshot::entry E{0, 0.0, type_(O), is_set_(O)};
+        const auto& V = snap->strings_[O];
+
+        switch (E.type) {
+            case ArgumentType::BOOL:
+                E.int_val = E.is_set;
+                break;
+            case ArgumentType::INT:
+            case ArgumentType::HEX:
+                E.int_val = std::strtoll(V.c_str(), nullptr, E.type == ArgumentType::HEX ? 16 : 10);
+                E.flt_val = static_cast<double>(E.int_val);
+                break;
+            case ArgumentType::FLT:
+                E.flt_val = std::strtod(V.c_str(), nullptr);
+                E.int_val = truncate_flt(E.flt_val);
+                break;
+            default:
+                break;
+        }
 
-            if (O.first.shr != "" && O.first.lng != "")
-                arg += "-" + O.first.shr + " | " + "--" + O.first.lng;
-            else if (O.first.shr != "")
-                arg += "-" + O.first.shr;
-            else if (O.first.lng != "")
-                arg += "--" + O.first.lng;
+        snap->entries_.push_back(E);
+    }
 
-            switch (O.second.type) {
-                case ArgumentType::HEX:
-                    arg += " [0x]<HEX>";
-                    break;
-                case ArgumentType::INT:
-                    arg += " <INT>";
-                    break;
-                case ArgumentType::FLT:
-                    arg += " <FLOAT>";
-                    break;
-                case ArgumentType::STR:
-                    arg += " <STRING>";
-                    break;
-                default:
-                    break;
-            }
+    snap->positional_.reserve(positional_.size());
+    for (auto&& P : positional_) {
+        snap->positional_.push_back(P.value);
+    }
 
-            if (std::find(this->mandatory_.begin(),
-                          this->mandatory_.end(),
-                          O.first)
-                != this->mandatory_.end())
-            {
-                req += arg + " ";
-            }
-            else
+    return snap;
+}
+
+std::string ArgumentParser::serialize() const
+{
+    const auto options = segments_.size();
+    auto size = sizeof(SNAPSHOT_MAGIC) + 2 * sizeof(std::uint16_t) + 3 * sizeof(std::uint32_t) + exec_name_.size();
+
+    for (auto O = 0u; O < options; O++) {
+        size += 2 * sizeof(std::uint8_t) + 2 * sizeof(std::uint16_t) + sizeof(std::uint32_t)
+                + segments_.key(O).shr.size() + segments_.key(O).lng.size() + value_(O).size();
+    }
+    for (auto&& P : positional_) {
+        size += sizeof(std::uint32_t) + P.value.size();
+    }
+
+    std::string buf;
+    buf.reserve(size);
+
+    buf.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    put<std::uint16_t>(buf, SNAPSHOT_VERSION);
+    put<std::uint16_t>(buf, 0);
+    put<std::uint32_t>(buf, static_cast<std::uint32_t>(options));
+    put<std::uint32_t>(buf, static_cast<std::uint32_t>(positional_.size()));
+
+    put<std::uint32_t>(buf, static_cast<std::uint32_t>(exec_name_.size()));
+    buf.append(exec_name_);
+
+    for (auto O = 0u; O < options; O++) {
+        const auto ak = segments_.key(O);
+        const auto val = value_(O);
+
+        put<std::uint8_t>(buf, static_cast<std::uint8_t>(type_(O)));
+        // raw flag, so options given on the command line stay distinguishable from defaults
+        put<std::uint8_t>(buf, O < set_.size() ? set_[O] : (segments_.has_default(O) ? IS_SET : 0));
+        put<std::uint16_t>(buf, static_cast<std::uint16_t>(ak.shr.size()));
+        put<std::uint16_t>(buf, static_cast<std::uint16_t>(ak.lng.size()));
+        put<std::uint32_t>(buf, static_cast<std::uint32_t>(val.size()));
+        buf.append(ak.shr).append(ak.lng).append(val);
+    }
+
+    for (auto&& P : positional_) {
+        put<std::uint32_t>(buf, static_cast<std::uint32_t>(P.value.size()));
+        buf.append(P.value);
+    }
+
+    return buf;
+}
+
+void ArgumentParser::deserialize(const char* data, std::size_t size)
+{
+    snapshot_reader rd{data, data + size};
+
+    if (std::memcmp(rd.bytes(sizeof(SNAPSHOT_MAGIC)), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::logic_error("Not an argument snapshot.");
+    }
+    if (rd.get<std::uint16_t>() != SNAPSHOT_VERSION) {
+        throw std::logic_error("Unsupported argument snapshot version.");
+    }
+    rd.get<std::uint16_t>();
+
+    const auto options = rd.get<std::uint32_t>();
+    const auto positionals = rd.get<std::uint32_t>();
+
+    const auto exe_len = rd.get<std::uint32_t>();
+    const auto exe = rd.bytes(exe_len);
+
+    // counts cannot exceed the records that fit into the rest, checked before anything is allocated
+    if (static_cast<std::uint64_t>(options) * SNAPSHOT_OPTION_MIN
+        + static_cast<std::uint64_t>(positionals) * SNAPSHOT_POSITIONAL_MIN
+        > static_cast<std::uint64_t>(rd.end - rd.cur))
+    {
+        throw std::logic_error("Truncated argument snapshot.");
+    }
+
+    // the whole snapshot is decoded and validated before the parser is changed
+    std::vector<snapshot_option> records;
+    std::set<std::string> added;
+
+    records.reserve(options);
+
+    for (auto O = 0u; O < options; O++) {
+        snapshot_option R;
+
+        R.type = rd.get<std::uint8_t>();
+        R.is_set = rd.get<std::uint8_t>();
+        const auto shr_len = rd.get<std::uint16_t>();
+        const auto lng_len = rd.get<std::uint16_t>();
+        R.val_len = rd.get<std::uint32_t>();
+        const auto shr = rd.bytes(shr_len);
+        const auto lng = rd.bytes(lng_len);
+        R.val = rd.bytes(R.val_len);
+
+        if (R.type > static_cast<std::uint8_t>(ArgumentType::FILE)) {
+            throw std::logic_error("Invalid option type in argument snapshot.");
+        }
+        if (R.is_set != 0 && R.is_set != IS_SET && R.is_set != IS_GIVEN) {
+            throw std::logic_error("Invalid option flag in argument snapshot.");
+        }
+
+        R.key = arg_key(std::string(shr, shr_len), std::string(lng, lng_len));
+        R.id = find_option_(R.key);
+
+        if (R.id == npos) {
+            // option is registered once the snapshot is validated, its names must be free
+            if (R.key.shr == R.key.lng
+                || (!R.key.shr.empty() && !added.insert("-" + R.key.shr).second)
+                || (!R.key.lng.empty() && !added.insert("--" + R.key.lng).second))
             {
-                opt += "[ " + arg +" ] ";
+                throw std::logic_error("Option in argument snapshot collides with registered options.");
             }
+        } else if (type_(R.id) != static_cast<ArgumentType>(R.type)) {
+            throw std::logic_error("Option " + option_name_(R.id) + " in argument snapshot has a different type.");
+        }
+
+        records.push_back(std::move(R));
+    }
+
+    std::vector<std::pair<const char*, std::uint32_t>> values;
+    values.reserve(positionals);
 
+    for (auto P = 0u; P < positionals; P++) {
+        const auto len = rd.get<std::uint32_t>();
+        values.emplace_back(rd.bytes(len), len);
+    }
+
+    // apply
+    exec_name_.assign(exe, exe_len);
 
+    for (auto&& R : records) {
+        if (R.id == npos) {
+            register_option(R.key, ArgumentOption::OPTIONAL, static_cast<ArgumentType>(R.type), "");
+            R.id = segments_.size() - 1;
         }
 
-        std::cout << req << opt;
+        materialize_();
+
+        values_[R.id].assign(R.val, R.val_len);
+        set_[R.id] = R.is_set;
+    }
+
+    if (positional_.size() < positionals) {
+        register_positional(positionals - static_cast<unsigned>(positional_.size()));
+    }
+
+    for (auto P = 0u; P < positionals; P++) {
+        positional_[P].value.assign(values[P].first, values[P].second);
+    }
+}
+
+namespace {
+
+/**
+ * @brief Output that only counts the bytes written to it.
+ */
+struct size_sink
+{
+    std::size_t size = 0;
+
+    void append(const char*, std::size_t len) { size += len; }
+};
+
+/**
+ * @brief Output appending to a string reserved in advance.
+ */
+struct string_sink
+{
+    std::string& buf;
+
+    void append(const char* str, std::size_t len) { buf.append(str, len); }
+};
 
-        for (auto P : this->positional_) {
-            std::cout << P.name << " ";
+template<typename Sink> void put_str(Sink& out, const std::string& str)
+{
+    out.append(str.data(), str.size());
+}
+
+template<typename Sink> void put_lit(Sink& out, const char* str)
+{
+    out.append(str, std::strlen(str));
+}
+
+template<typename Sink> void put_escaped(Sink& out, const std::string& str, ConfigFormat fmt)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    const bool json = fmt == ConfigFormat::JSON;
+    auto run = str.data();
+
+    for (auto c = str.data(); c != str.data() + str.size(); c++) {
+        const auto u = static_cast<unsigned char>(*c);
+
+        if (u >= 0x20 && u != '\\' && !(json && u == '"')) {
+            continue;
+        }
+
+        // flush the run of plain characters before the escaped one
+        out.append(run, static_cast<std::size_t>(c - run));
+        run = c + 1;
+
+        if (u == '\\' || u == '"') {
+            const char esc[] = {'\\', *c};
+            out.append(esc, sizeof(esc));
+        } else if (u == '\n') {
+            out.append("\\n", 2);
+        } else if (u == '\t') {
+            out.append("\\t", 2);
+        } else if (json) {
+            const char esc[] = {'\\', 'u', '0', '0', HEX_DIGITS[u >> 4], HEX_DIGITS[u & 0xf]};
+            out.append(esc, sizeof(esc));
+        } else {
+            const char esc[] = {'\\', 'x', HEX_DIGITS[u >> 4], HEX_DIGITS[u & 0xf]};
+            out.append(esc, sizeof(esc));
         }
+    }
+
+    out.append(run, static_cast<std::size_t>(str.data() + str.size() - run));
+}
+
+template<typename Sink> void put_uint(Sink& out, std::size_t val)
+{
+    char digits[20];
+    auto d = digits + sizeof(digits);
 
-        std::cout << '\b' << std::endl;
+    do {
+        *--d = static_cast<char>('0' + val % 10);
+        val /= 10;
+    } while (val);
+
+    out.append(d, static_cast<std::size_t>(digits + sizeof(digits) - d));
+}
+
+const char* type_name(ArgumentType type)
+{
+    switch (type) {
+        case ArgumentType::BOOL:
+            return "BOOL";
+        case ArgumentType::INT:
+            return "INT";
+        case ArgumentType::HEX:
+            return "HEX";
+        case ArgumentType::FLT:
+            return "FLT";
+        case ArgumentType::FILE:
+            return "FILE";
+        default:
+            return "STR";
     }
 }
 
-void ArgumentParser::print_help_text()
+}
+
+template<typename Sink> void ArgumentParser::dump_config_(Sink& out, ConfigFormat fmt) const
 {
-    print_usage_text();
+    const bool json = fmt == ConfigFormat::JSON;
 
-	std::cout << prog_desc_ << std::endl << std::endl;
+    if (json) {
+        put_lit(out, "{\"exec\":\"");
+        put_escaped(out, exec_name_, fmt);
+        put_lit(out, "\",\"options\":[");
+    } else {
+        put_lit(out, "exec=");
+        put_escaped(out, exec_name_, fmt);
+        put_lit(out, "\n");
+    }
 
-	std::cout << "Available options_:" << std::endl;
+    for (auto O = 0u; O < segments_.size(); O++) {
+        const auto ak = segments_.key(O);
+        const auto flags = O < set_.size() ? set_[O] : (segments_.has_default(O) ? IS_SET : 0);
+        const auto source = flags == IS_GIVEN ? "set" : (flags ? "default" : "unset");
+        const auto val = O < values_.size() ? std::string() : segments_.default_value(O);
+        const auto& value = O < values_.size() ? values_[O] : val;
+
+        if (json) {
+            put_lit(out, O ? ",{\"short\":\"" : "{\"short\":\"");
+            put_escaped(out, ak.shr, fmt);
+            put_lit(out, "\",\"long\":\"");
+            put_escaped(out, ak.lng, fmt);
+            put_lit(out, "\",\"type\":\"");
+            put_lit(out, type_name(type_(O)));
+            put_lit(out, "\",\"value\":\"");
+            put_escaped(out, value, fmt);
+            put_lit(out, "\",\"source\":\"");
+            put_lit(out, source);
+            put_lit(out, "\",\"groups\":[");
+        } else {
+            put_lit(out, ak.lng.empty() ? "-" : "--");
+            put_str(out, ak.lng.empty() ? ak.shr : ak.lng);
+            put_lit(out, "=");
+            put_escaped(out, value, fmt);
+            put_lit(out, "\ttype=");
+            put_lit(out, type_name(type_(O)));
+            put_lit(out, "\tsource=");
+            put_lit(out, source);
+            put_lit(out, "\tgroups=");
+        }
 
-	for (auto&& O : options_) {
-        size_t pos;
-		std::string opt;
-		if (O.first.shr != "" && O.first.lng != "")
-			opt = "-" + O.first.shr + ", " + "--" + O.first.lng;
-		else if (O.first.shr != "")
-			opt = "-" + O.first.shr;
-		else if (O.first.lng != "")
-			opt = "--" + O.first.lng;
+        auto first = true;
+        for (auto&& G : mtx_groups_) {
+            if (std::find(G.second.begin(), G.second.end(), O) != G.second.end()) {
+                put_lit(out, first ? "" : ",");
+                put_lit(out, json ? "\"" : "");
+                put_escaped(out, G.first, fmt);
+                put_lit(out, json ? "\"" : "");
+                first = false;
+            }
+        }
 
-		size_t next;
-		std::cout << std::left << std::setw(OPT_WIDTH_) << opt;
-		pos = O.second.desc.find_first_of('\n');
-		std::cout << O.second.desc.substr(0, pos);
-		next = pos + 1;
+        put_lit(out, json ? "]}" : "\n");
+    }
 
-		while (pos != std::string::npos) {
-			std::cout << std::endl;
-			pos = O.second.desc.find_first_of('\n', next);
-			std::cout << std::left << std::setw(OPT_WIDTH_) << " ";
-			std::cout << O.second.desc.substr(next, pos) << std::endl;
-			next = pos + 1;
-		}
-		std::cout << std::endl;
+    put_lit(out, json ? "],\"positional\":[" : "");
+
+    for (auto P = 0u; P < positional_.size(); P++) {
+        if (json) {
+            put_lit(out, P ? ",\"" : "\"");
+            put_escaped(out, positional_[P].value, fmt);
+            put_lit(out, "\"");
+        } else {
+            put_lit(out, "#");
+            put_uint(out, P);
+            put_lit(out, "=");
+            put_escaped(out, positional_[P].value, fmt);
+            put_lit(out, "\n");
+        }
+    }
 
-		if (O.second.has_default) {
-			std::cout << std::left << std::setw(OPT_WIDTH_) << " ";
-			std::cout << "Default value: " << O.second.value << std::endl;
-		}
+    put_lit(out, json ? "]}\n" : "");
+}
 
-		std::cout << std::endl;
-	}
+std::string ArgumentParser::dump_config(ConfigFormat fmt) const
+{
+    size_sink size;
+    dump_config_(size, fmt);
+
+    std::string buf;
+    buf.reserve(size.size);
+
+    string_sink out{buf};
+    dump_config_(out, fmt);
+
+    return buf;
 }
 
+arg_footprint ArgumentParser::footprint() const
+{
+    arg_footprint fp{segments_.size(), 0, 0, 0};
+
+    fp.hot_bytes = values_.capacity() * sizeof(std::string)
+                   + types_.capacity() * sizeof(ArgumentType)
+                   + set_.capacity() * sizeof(std::uint8_t);
 
+    for (auto&& V : values_) {
+        // only values that do not fit into the string itself own heap memory
+        if (V.capacity() > std::string().capacity()) {
+            fp.hot_bytes += V.capacity() + 1;
+        }
+    }
+
+    fp.hot_bytes += constraint_idx_.capacity() * sizeof(std::uint32_t);
+
+    fp.cold_bytes = segments_.bytes(false)
+                    + constraints_.capacity() * sizeof(arg_constraint);
+    fp.shared_bytes = segments_.bytes(true);
+
+    for (auto&& G : mtx_groups_) {
+        fp.cold_bytes += G.second.capacity() * sizeof(std::size_t);
+    }
+
+    return fp;
+}
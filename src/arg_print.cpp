@@ -0,0 +1,193 @@
+/**
+ * @file arg_print.cpp
+ * @brief Help text and configuration output.
+ * @date 2026-10-18
+ *
+ * Output goes through C stdio rather than iostreams, so the library has no static
+ * initializers. Standard iostreams are synchronized with stdio, output stays in order.
+ */
+
+#include <algorithm>
+#include <cstdio>
+
+#if !defined(_WIN32) && !defined(WIN32)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+#include "arg_parser.hpp"
+
+namespace {
+
+void put(const std::string& str)
+{
+    std::fwrite(str.data(), 1, str.size(), stdout);
+}
+
+// left aligned field as std::left << std::setw(width) would write it
+void put_field(const std::string& str, std::size_t width)
+{
+    put(str);
+    if (str.size() < width) {
+        put(std::string(width - str.size(), ' '));
+    }
+}
+
+}
+
+void ArgumentParser::print_config(ConfigFormat fmt) const
+{
+    const auto buf = dump_config(fmt);
+
+    // earlier buffered output goes first
+    std::fflush(stdout);
+
+#if !defined(_WIN32) && !defined(WIN32)
+    // bypass stdio buffering, which would split the document into buffer-sized writes
+    auto data = buf.data();
+    auto left = buf.size();
+
+    while (left > 0) {
+        const auto n = ::write(STDOUT_FILENO, data, left);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::logic_error("Writing configuration to standard output failed.");
+        }
+        data += n;
+        left -= static_cast<std::size_t>(n);
+    }
+#else
+    put(buf);
+    std::fflush(stdout);
+#endif
+}
+
+void ArgumentParser::print_usage_text()
+{
+    auto req = static_cast<std::string>("");
+    auto opt = static_cast<std::string>("");
+
+    put("Usage: ");
+
+    put(exec_name_ + " ");
+
+    if (!usage_.empty()) {
+        put(usage_ + "\n");
+    } else {
+        std::vector<std::size_t> mandatory;
+        segments_.for_each_mandatory([&mandatory](std::size_t M) { mandatory.push_back(M); });
+
+        for (auto O = 0u; O < segments_.size(); O++) {
+            auto arg = static_cast<std::string>("");
+            const auto ak = segments_.key(O);
+            const auto& shr = ak.shr;
+            const auto& lng = ak.lng;
+
+            if (shr == "h" || lng == "help") {
+                //
+                continue;
+            }
+
+            if (shr != "" && lng != "")
+                arg += "-" + shr + " | " + "--" + lng;
+            else if (shr != "")
+                arg += "-" + shr;
+            else if (lng != "")
+                arg += "--" + lng;
+
+            switch (type_(O)) {
+                case ArgumentType::HEX:
+                    arg += " [0x]<HEX>";
+                    break;
+                case ArgumentType::INT:
+                    arg += " <INT>";
+                    break;
+                case ArgumentType::FLT:
+                    arg += " <FLOAT>";
+                    break;
+                case ArgumentType::STR:
+                    arg += " <STRING>";
+                    break;
+                case ArgumentType::FILE:
+                    arg += " <FILE>";
+                    break;
+                default:
+                    break;
+            }
+
+            if (std::find(mandatory.begin(),
+                          mandatory.end(),
+                          O)
+                != mandatory.end())
+            {
+                req += arg + " ";
+            }
+            else
+            {
+                opt += "[ " + arg +" ] ";
+            }
+
+
+        }
+
+        put(req + opt);
+
+        for (auto P : this->positional_) {
+            put(P.name + " ");
+        }
+
+        put("\b\n");
+    }
+
+    std::fflush(stdout);
+}
+
+void ArgumentParser::print_help_text()
+{
+    print_usage_text();
+
+	put(prog_desc_ + "\n\n");
+
+	put("Available options_:\n");
+
+	for (auto O = 0u; O < segments_.size(); O++) {
+        size_t pos;
+		std::string opt;
+		const auto ak = segments_.key(O);
+		const auto& shr = ak.shr;
+		const auto& lng = ak.lng;
+		const auto desc = segments_.desc(O);
+		if (shr != "" && lng != "")
+			opt = "-" + shr + ", " + "--" + lng;
+		else if (shr != "")
+			opt = "-" + shr;
+		else if (lng != "")
+			opt = "--" + lng;
+
+		size_t next;
+		put_field(opt, OPT_WIDTH_);
+		pos = desc.find_first_of('\n');
+		put(desc.substr(0, pos));
+		next = pos + 1;
+
+		while (pos != std::string::npos) {
+			put("\n");
+			pos = desc.find_first_of('\n', next);
+			put_field(" ", OPT_WIDTH_);
+			put(desc.substr(next, pos) + "\n");
+			next = pos + 1;
+		}
+		put("\n");
+
+		if (segments_.has_default(O)) {
+			put_field(" ", OPT_WIDTH_);
+			put("Default value: " + segments_.default_value(O) + "\n");
+		}
+
+		put("\n");
+	}
+
+	std::fflush(stdout);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file arg_proc.cpp
+ * @brief Parsing command lines of running processes.
+ * @date 2026-10-18
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "arg_proc.hpp"
+
+ProcessScanner::ProcessScanner(const ArgumentParser& schema, std::string proc_root)
+    : args_(schema),
+      proc_root_(std::move(proc_root)),
+      buf_(4096)
+{
+}
+
+#if defined(__linux__)
+
+bool ProcessScanner::read_cmdline_(const char* pid, std::size_t& len)
+{
+    path_.assign(proc_root_).append("/").append(pid).append("/cmdline");
+
+    const auto fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    len = 0;
+    for (;;) {
+        if (len == buf_.size()) {
+            buf_.resize(buf_.size() * 2);
+        }
+
+        const auto got = ::read(fd, buf_.data() + len, buf_.size() - len);
+        if (got <= 0) {
+            break;
+        }
+        len += static_cast<std::size_t>(got);
+    }
+
+    ::close(fd);
+
+    return len != 0;
+}
+
+std::size_t ProcessScanner::scan(const callback_t& cb)
+{
+    const auto dir = ::opendir(proc_root_.c_str());
+    if (!dir) {
+        return 0;
+    }
+
+    std::size_t count = 0;
+
+    while (const auto ent = ::readdir(dir)) {
+        const auto name = ent->d_name;
+
+        // only numeric entries are processes, kernel threads have empty command line
+        std::size_t len = 0;
+        if (name[0] < '0' || name[0] > '9' || !read_cmdline_(name, len)) {
+            continue;
+        }
+
+        if (!exec_filter_.empty()) {
+            const auto exe_end = static_cast<const char*>(std::memchr(buf_.data(), '\0', len));
+            const auto exe_len = exe_end ? static_cast<std::size_t>(exe_end - buf_.data()) : len;
+            auto exe = buf_.data() + exe_len;
+
+            while (exe != buf_.data() && exe[-1] != '/') {
+                exe--;
+            }
+
+            if (static_cast<std::size_t>(buf_.data() + exe_len - exe) != exec_filter_.size()
+                || exec_filter_.compare(0, exec_filter_.size(), exe, exec_filter_.size()) != 0)
+            {
+                continue;
+            }
+        }
+
+        error_.clear();
+        args_.reset();
+
+        try {
+            args_.load_cmdline(buf_.data(), len);
+        } catch (std::logic_error& ex) {
+            error_ = ex.what();
+        }
+
+        cb(std::atoi(name), args_, error_);
+        count++;
+    }
+
+    ::closedir(dir);
+
+    return count;
+}
+
+#else
+
+bool ProcessScanner::read_cmdline_(const char*, std::size_t&)
+{
+    return false;
+}
+
+std::size_t ProcessScanner::scan(const callback_t&)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file arg_reload.cpp
+ * @brief Reloadable arguments published as immutable snapshots.
+ * @date 2026-10-18
+ */
+
+#include "arg_reload.hpp"
+
+namespace {
+
+// generations are unique across reloaders, so a cached generation identifies its snapshot
+std::atomic<std::uint64_t> last_generation(0);
+
+/**
+ * @brief Snapshot a reader thread got last.
+ */
+struct snapshot_cache {
+    std::uint64_t generation = 0;
+    std::shared_ptr<const ArgumentSnapshot> snapshot;
+};
+
+std::string option_name(const arg_key& ak)
+{
+    return (ak.shr.empty() ? "-" : "-" + ak.shr) + "/" + (ak.lng.empty() ? "-" : "--" + ak.lng);
+}
+
+std::vector<arg_change> diff(const ArgumentSnapshot& from, const ArgumentSnapshot& to)
+{
+    std::vector<arg_change> changes;
+
+    // both snapshots come from copies of the same prototype, options share their ids
+    for (auto O = 0u; O < to.size(); O++) {
+        if (from.value(O) != to.value(O) || from.option_is_set(O) != to.option_is_set(O)) {
+            changes.push_back({option_name(to.key(O)),
+                               from.value(O),
+                               to.value(O),
+                               from.option_is_set(O),
+                               to.option_is_set(O)});
+        }
+    }
+
+    for (auto P = 0u; P < to.positional_count(); P++) {
+        if (P >= from.positional_count() || from[P] != to[P]) {
+            changes.push_back({"#" + std::to_string(P),
+                               P < from.positional_count() ? from[P] : "",
+                               to[P],
+                               P < from.positional_count(),
+                               true});
+        }
+    }
+
+    return changes;
+}
+
+}
+
+ArgumentReloader::ArgumentReloader(ArgumentParser prototype, source_t source)
+    : prototype_(std::move(prototype)),
+      source_(std::move(source)),
+      generation_(0)
+{
+    std::string error;
+
+    auto snap = load_(error);
+    if (!error.empty()) {
+        throw std::logic_error(error);
+    }
+
+    publish_(std::move(snap));
+}
+
+std::shared_ptr<const ArgumentSnapshot> ArgumentReloader::current() const
+{
+    thread_local snapshot_cache cache;
+
+    if (cache.generation != generation_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(publisher_);
+        cache.snapshot = current_;
+        cache.generation = generation_.load(std::memory_order_relaxed);
+    }
+
+    return cache.snapshot;
+}
+
+void ArgumentReloader::publish_(std::shared_ptr<const ArgumentSnapshot> snap)
+{
+    {
+        std::lock_guard<std::mutex> lock(publisher_);
+        current_.swap(snap);
+        generation_.store(++last_generation, std::memory_order_release);
+    }
+
+    // replaced snapshot is released outside the lock, readers may hold it further
+}
+
+std::shared_ptr<const ArgumentSnapshot> ArgumentReloader::load_(std::string& error) const
+{
+    auto args = source_();
+    std::vector<char*> argv;
+
+    if (args.empty()) {
+        args.emplace_back("");
+    }
+
+    argv.reserve(args.size() + 1);
+    for (auto&& A : args) {
+        argv.push_back(&A[0]);
+    }
+    argv.push_back(nullptr);
+
+    ArgumentParser parser(prototype_);
+
+    try {
+        parser.load_arguments(static_cast<int>(args.size()), argv.data());
+    } catch (std::logic_error& ex) {
+        error = ex.what();
+    }
+
+    // rejected state is frozen as well to report what it would have changed
+    return parser.freeze();
+}
+
+arg_reload_result ArgumentReloader::reload()
+{
+    std::lock_guard<std::mutex> lock(writer_);
+
+    arg_reload_result result{false, "", {}};
+    auto snap = load_(result.error);
+
+    // only reloads change the published snapshot, it is stable under the writer lock
+    result.changes = diff(*current_, *snap);
+
+    if (result.error.empty()) {
+        publish_(std::move(snap));
+        result.accepted = true;
+    }
+
+    return result;
+}
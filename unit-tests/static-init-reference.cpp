@@ -0,0 +1,5 @@
+// empty shared library, its .init_array holds only what the toolchain adds to every library
+int static_init_reference()
+{
+    return 0;
+}
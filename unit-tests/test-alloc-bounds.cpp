@@ -0,0 +1,119 @@
+#include <iostream>
+#include "arg_alloc.hpp"
+#include "arg_parser.hpp"
+
+ARG_ALLOC_COUNTING_NEW
+
+// counted allocations must not exceed the bound
+static bool check(const char* what, const arg_alloc_counter& counter, std::size_t bound)
+{
+    const auto st = counter.stats();
+
+    std::cout << what << ": " << st.allocations << " allocations, " << st.bytes << " bytes" << std::endl;
+
+    if (st.allocations > bound) {
+        std::cerr << what << " exceeds " << bound << " allocations." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+
+    // option names and command line are prepared before counting starts
+    std::vector<std::string> names;
+    std::vector<std::string> tokens{"test"};
+
+    for (auto O = 0; O < 50; O++) {
+        names.push_back("option-" + std::to_string(O));
+        tokens.push_back("--" + names.back());
+        tokens.push_back(std::to_string(O));
+    }
+    tokens.emplace_back("positional");
+
+    std::vector<char*> argv;
+    for (auto&& T : tokens) {
+        argv.push_back(const_cast<char*>(T.c_str()));
+    }
+
+    // values too long for the small string buffer
+    auto long_tokens = tokens;
+    for (auto T = 2u; T < long_tokens.size(); T += 2) {
+        long_tokens[T].insert(0, 32, '0');
+    }
+
+    std::vector<char*> long_argv;
+    for (auto&& T : long_tokens) {
+        long_argv.push_back(const_cast<char*>(T.c_str()));
+    }
+
+    const arg_key help_key("h", "help");
+    const arg_key key("o", "option");
+    const std::string desc("Option with description longer than the small string buffer.");
+
+    {
+        // help option is shared, not registered again
+        ArgumentParser warmup;
+    }
+
+    arg_alloc_counter counter;
+    ArgumentParser args;
+    ok &= check("Constructor", counter, 1);
+
+    counter.restart();
+    args.register_option(key, ArgumentOption::OPTIONAL, ArgumentType::INT, desc);
+    ok &= check("First option", counter, 20);
+
+    counter.restart();
+    for (auto&& N : names) {
+        args.register_option({"", N}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+    }
+    args.register_positional(1);
+    ok &= check("50 options", counter, 64);
+
+    counter.restart();
+    args.load_arguments(static_cast<int>(argv.size()), argv.data());
+    ok &= check("Loading 50 options", counter, 2);
+
+    counter.restart();
+    args.reset();
+    args.load_arguments(static_cast<int>(argv.size()), argv.data());
+    ok &= check("Loading 50 options again", counter, 0);
+
+    // value buffers grow once and are reused by later loads
+    counter.restart();
+    args.reset();
+    args.load_arguments(static_cast<int>(long_argv.size()), long_argv.data());
+    ok &= check("Loading 50 long values", counter, 50);
+
+    counter.restart();
+    args.reset();
+    args.load_arguments(static_cast<int>(long_argv.size()), long_argv.data());
+    ok &= check("Loading 50 long values again", counter, 0);
+
+    args.reset();
+    args.load_arguments(static_cast<int>(argv.size()), argv.data());
+
+    counter.restart();
+    long sum = 0;
+    for (auto&& N : names) {
+        sum += args.option_is_set(N) + args.has_option(N);
+    }
+    sum += args.option_is_set(help_key) + args.exec_name().size() + args[0].size();
+    ok &= check("Option lookups", counter, 0);
+
+    counter.restart();
+    for (auto&& N : names) {
+        sum += args[N].size();
+    }
+    ok &= check("Option values", counter, 0);
+
+    if (sum != 100 + 4 + 10 + 90) {
+        ok = false;
+        std::cerr << "Unexpected option values." << std::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
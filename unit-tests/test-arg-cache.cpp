@@ -0,0 +1,139 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "arg_cache.hpp"
+
+// argument vector of a command line with given number
+struct command_line {
+    std::vector<std::string> tokens;
+    std::vector<char*> argv;
+
+    explicit command_line(int n)
+        : tokens{"daemon", "--port", std::to_string(8000 + n), "--name=job-" + std::to_string(n), "-v", "input"}
+    {
+        for (auto&& T : tokens) {
+            argv.push_back(const_cast<char*>(T.c_str()));
+        }
+    }
+
+    int argc() { return static_cast<int>(argv.size()); }
+};
+
+int main()
+{
+    ArgumentParser args("Unit test for the argument cache.");
+
+    args.register_option({"p", "port"}, ArgumentOption::REQUIRED, ArgumentType::INT, "");
+    args.register_option({"", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    args.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_positional(1);
+
+    ArgumentCache cache(args, 4);
+
+    std::vector<command_line> lines;
+    for (auto n = 0; n < 16; n++) {
+        lines.emplace_back(n);
+    }
+
+    bool ok = true;
+
+    const auto first = cache.parse(lines[0].argc(), lines[0].argv.data());
+    const auto again = cache.parse(lines[0].argc(), lines[0].argv.data());
+
+    if (first != again || first->get<int>("port") != 8000 || (*first)["name"] != "job-0" || (*first)[0] != "input"
+        || cache.stats().hits != 1 || cache.stats().misses != 1)
+    {
+        ok = false;
+        std::cerr << "Repeated command line was not served from the cache." << std::endl;
+    }
+
+    // invalid command lines are not cached
+    for (auto i = 0; i < 2; i++) {
+        try {
+            cache.parse(3, lines[0].argv.data() + 3);
+            ok = false;
+            std::cerr << "Invalid command line was accepted." << std::endl;
+        } catch (std::logic_error&) {
+        }
+    }
+
+    if (cache.stats().misses != 3 || cache.stats().entries != 1) {
+        ok = false;
+        std::cerr << "Invalid command line was cached." << std::endl;
+    }
+
+    // lines[0] is referenced, CLOCK evicts lines[1] when lines[4] does not fit
+    for (auto n = 1; n < 5; n++) {
+        cache.parse(lines[n].argc(), lines[n].argv.data());
+    }
+    cache.parse(lines[0].argc(), lines[0].argv.data());
+
+    if (cache.parse(lines[0].argc(), lines[0].argv.data()) != first || cache.stats().evictions != 1
+        || cache.stats().entries != 4)
+    {
+        ok = false;
+        std::cerr << "Referenced entry was evicted." << std::endl;
+    }
+
+    // prefix of a cached command line is a different command line
+    lines[5].argv.pop_back();
+    try {
+        cache.parse(lines[5].argc(), lines[5].argv.data());
+        ok = false;
+        std::cerr << "Prefix of a cached command line was accepted." << std::endl;
+    } catch (std::logic_error&) {
+    }
+    lines[5].argv.push_back(const_cast<char*>(lines[5].tokens.back().c_str()));
+
+    // concurrent readers over more command lines than the cache holds
+    ArgumentCache shared(args, 8);
+    std::atomic<bool> good(true);
+    std::vector<std::thread> readers;
+
+    for (auto t = 0; t < 8; t++) {
+        readers.emplace_back([&, t]()
+        {
+            for (auto i = 0; i < 20000; i++) {
+                auto n = (i % 64 == 0) ? (i / 64 + t) % 16 : (i + t) % 8;
+                const auto snap = shared.parse(lines[n].argc(), lines[n].argv.data());
+                if (snap->get<int>("port") != 8000 + n || (*snap)["name"] != "job-" + std::to_string(n)) {
+                    good = false;
+                }
+            }
+        });
+    }
+
+    for (auto&& R : readers) {
+        R.join();
+    }
+
+    const auto st = shared.stats();
+    std::cout << "Concurrent: " << st.hits << " hits, " << st.misses << " misses, " << st.evictions << " evictions, "
+              << st.hit_ratio() * 100 << " % hit ratio" << std::endl;
+
+    if (!good || st.hits + st.misses != 8 * 20000 || st.entries != 8 || st.hit_ratio() < 0.5) {
+        ok = false;
+        std::cerr << "Concurrent lookups returned wrong arguments." << std::endl;
+    }
+
+    // hit against a full load of the same command line
+    const auto loops = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < loops; i++) {
+        cache.parse(lines[0].argc(), lines[0].argv.data());
+    }
+    const std::chrono::duration<double, std::nano> hit = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < loops; i++) {
+        ArgumentParser A(args);
+        A.load_arguments(lines[0].argc(), lines[0].argv.data());
+        A.freeze();
+    }
+    const std::chrono::duration<double, std::nano> load = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Cached: " << hit.count() / loops << " ns, loaded: " << load.count() / loops << " ns" << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
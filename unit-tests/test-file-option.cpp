@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <unistd.h>
+#include "arg_parser.hpp"
+
+// flag if the file is mapped into this process
+static bool is_mapped(const std::string& path)
+{
+#if defined(__linux__)
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+
+    while (std::getline(maps, line)) {
+        if (line.size() >= path.size() && line.compare(line.size() - path.size(), path.size(), path) == 0) {
+            return true;
+        }
+    }
+    return false;
+#else
+    (void)path;
+    return true;
+#endif
+}
+
+int main()
+{
+    char path_tmpl[] = "/tmp/test-file-option-XXXXXX";
+    const auto fd = mkstemp(path_tmpl);
+    const std::string path(path_tmpl);
+
+    // 8 MiB payload
+    std::string payload(8 << 20, '\0');
+    for (auto i = 0u; i < payload.size(); i++) {
+        payload[i] = static_cast<char>(i * 31 + 7);
+    }
+    std::ofstream(path, std::ios::binary) << payload;
+
+    const auto empty_path = path + ".empty";
+    std::ofstream(empty_path, std::ios::binary);
+
+    ArgumentParser proto("Unit test for file options.");
+    proto.register_option({"p", "payload"}, ArgumentOption::REQUIRED, ArgumentType::FILE, "");
+    proto.register_option({"e", "empty"}, ArgumentOption::OPTIONAL, ArgumentType::FILE, "");
+    proto.register_option({"m", "missing"}, ArgumentOption::OPTIONAL, ArgumentType::FILE, "");
+    proto.register_option({"n", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+
+    bool ok = true;
+
+    {
+        ArgumentParser args(proto);
+
+        const auto cmdline = std::string("test\0--payload\0", 15) + path + std::string("\0-e\0", 4) + empty_path
+                             + std::string("\0-m\0/nonexistent/file", 21);
+        args.load_cmdline(cmdline.data(), cmdline.size());
+
+        if (is_mapped(path) && args["payload"] == path) {
+            ok = false;
+            std::cerr << "File was mapped before first access." << std::endl;
+        }
+
+        const auto bytes = args.file_bytes("payload");
+        if (bytes.size != payload.size() || std::string(bytes.begin(), bytes.end()) != payload || !is_mapped(path)) {
+            ok = false;
+            std::cerr << "File contents are not mapped." << std::endl;
+        }
+
+        if (args.file_bytes("p").data != bytes.data) {
+            ok = false;
+            std::cerr << "File was mapped again." << std::endl;
+        }
+
+        if (!args.file_bytes("empty").empty()) {
+            ok = false;
+            std::cerr << "Empty file has contents." << std::endl;
+        }
+
+        for (auto key : {"missing", "name", "unknown"}) {
+            try {
+                args.file_bytes(key);
+                ok = false;
+                std::cerr << "Option " << key << " was mapped." << std::endl;
+            } catch (std::logic_error&) {
+            }
+        }
+
+        args.reset();
+        if (is_mapped(path) || !args.file_bytes("empty").empty()) {
+            ok = false;
+            std::cerr << "File was not unmapped by reset." << std::endl;
+        }
+
+        const auto again = std::string("test\0-p\0", 8) + path;
+        args.load_cmdline(again.data(), again.size());
+        args.file_bytes("payload");
+    }
+
+    if (is_mapped(path)) {
+        ok = false;
+        std::cerr << "File was not unmapped with the parser." << std::endl;
+    }
+
+    close(fd);
+    std::remove(path.c_str());
+    std::remove(empty_path.c_str());
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
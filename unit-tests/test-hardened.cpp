@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "arg_parser.hpp"
+
+// command line buffer with the layout of /proc/<pid>/cmdline
+static std::string cmdline(std::initializer_list<std::string> tokens)
+{
+    std::string buf;
+    for (auto&& T : tokens) {
+        buf.append(T).push_back('\0');
+    }
+    return buf;
+}
+
+static bool expect_error(ArgumentParser& args, const std::string& buf, ArgumentErrorCode code, std::size_t token)
+{
+    args.reset();
+    try {
+        args.load_cmdline(buf.data(), buf.size());
+    } catch (ArgumentError& ex) {
+        if (ex.code() == code && ex.token() == token) {
+            return true;
+        }
+        std::cerr << "Unexpected error at token " << ex.token() << ": " << ex.what() << std::endl;
+        return false;
+    }
+    std::cerr << "Command line was not rejected: " << buf.size() << " bytes" << std::endl;
+    return false;
+}
+
+// median time of loading the buffer in microseconds
+static double load_time(ArgumentParser& args, const std::string& buf)
+{
+    std::vector<double> times;
+
+    for (auto i = 0; i < 51; i++) {
+        args.reset();
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            args.load_cmdline(buf.data(), buf.size());
+        } catch (ArgumentError&) {
+        }
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::nth_element(times.begin(), times.begin() + 25, times.end());
+    return times[25];
+}
+
+int main()
+{
+    ArgumentParser args("Unit test for limits of untrusted command lines.");
+
+    args.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"n", "count"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+    args.register_option({"", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    args.register_positional(1);
+
+    args.set_limits(arg_limits{8, 16, 64, 3});
+
+    bool ok = true;
+
+    const auto within = cmdline({"job", "-vv", "-n", "5", "--name=abcdefghi", "pos"});
+    args.load_cmdline(within.data(), within.size());
+    if (!args.option_is_set("v") || args.parse_option<int>("n") != 5 || args[0] != "pos") {
+        ok = false;
+        std::cerr << "Command line within limits was not loaded." << std::endl;
+    }
+
+    ok &= expect_error(args, cmdline({"job", "--name", "a", "-n", "1", "-v", "--name", "b", "-n", "2"}),
+                       ArgumentErrorCode::TOO_MANY_TOKENS, 9);
+    ok &= expect_error(args, cmdline({"job", "--name", "abcdefghijklmnopq", "pos"}), ArgumentErrorCode::TOKEN_TOO_LONG, 2);
+    ok &= expect_error(args, cmdline({"a-very-long-executable"}), ArgumentErrorCode::TOKEN_TOO_LONG, 0);
+    ok &= expect_error(args, cmdline({"job", "--name", "abcdefghijklmnop", "--name", "abcdefghijklmnop", "--name", "abcdefghijklmnop"}),
+                       ArgumentErrorCode::INPUT_TOO_LONG, ArgumentError::no_token);
+    ok &= expect_error(args, std::string(100, 'x'), ArgumentErrorCode::INPUT_TOO_LONG, ArgumentError::no_token);
+    ok &= expect_error(args, cmdline({"job", "-vvvv", "pos"}), ArgumentErrorCode::TOO_MANY_ELEMENTS, 1);
+    ok &= expect_error(args, cmdline({"job", "-vv", "--verbose", "-v", "pos"}), ArgumentErrorCode::TOO_MANY_ELEMENTS, 3);
+    ok &= expect_error(args, cmdline({"job", "-x"}), ArgumentErrorCode::UNKNOWN_OPTION, 1);
+    ok &= expect_error(args, cmdline({"job", "a", "b"}), ArgumentErrorCode::TOO_MANY_POSITIONALS, 2);
+    ok &= expect_error(args, cmdline({"job", "a", "-v"}), ArgumentErrorCode::POSITIONAL_ORDER, 2);
+    ok &= expect_error(args, cmdline({"job", "-v"}), ArgumentErrorCode::INVALID_ARGUMENTS, ArgumentError::no_token);
+
+    // argv is rejected by its count before any token is read, its length is counted token by token
+    std::vector<std::string> many(10, "-v");
+    std::vector<std::string> large{"job", "--name", "abcdefghijklmnop", "--name", "abcdefghijklmnop", "--name", "abcdefghijklmnop"};
+
+    for (auto V : {&many, &large}) {
+        std::vector<char*> argv;
+        for (auto&& A : *V) {
+            argv.push_back(const_cast<char*>(A.c_str()));
+        }
+
+        args.reset();
+        try {
+            args.load_arguments(static_cast<int>(argv.size()), argv.data());
+            ok = false;
+            std::cerr << "Argument vector was not rejected." << std::endl;
+        } catch (ArgumentError& ex) {
+            if (ex.code() != (V == &many ? ArgumentErrorCode::TOO_MANY_TOKENS : ArgumentErrorCode::INPUT_TOO_LONG)
+                || ex.token() != (V == &many ? 9 : 6))
+            {
+                ok = false;
+                std::cerr << "Unexpected error of argument vector: " << ex.what() << std::endl;
+            }
+        }
+    }
+
+    // random command lines are either loaded or rejected with ArgumentError
+    args.set_limits(arg_limits::untrusted());
+
+    const std::vector<std::string> dict{"-v", "-n", "--name", "--name=", "--count=-1", "-", "--", "-vn", "-n-5", "=", "x"};
+    std::mt19937 rng(2016);
+    std::size_t loaded = 0;
+
+    for (auto i = 0; i < 100000; i++) {
+        std::string buf("job");
+        const auto tokens = rng() % 12;
+        for (auto t = 0u; t < tokens; t++) {
+            buf.push_back('\0');
+            if (rng() % 4) {
+                buf.append(dict[rng() % dict.size()]);
+            } else {
+                for (auto b = rng() % 8; b; b--) {
+                    buf.push_back(static_cast<char>(rng()));
+                }
+            }
+        }
+
+        args.reset();
+        try {
+            args.load_cmdline(buf.data(), buf.size());
+            loaded++;
+        } catch (ArgumentError&) {
+        } catch (std::exception& ex) {
+            ok = false;
+            std::cerr << "Unstructured error: " << ex.what() << std::endl;
+            break;
+        }
+    }
+
+    // worst-case load time does not grow with the input once the limits are reached
+    const auto lim = arg_limits::untrusted();
+    const std::string flag("-v\0", 3);
+    const std::string long_tok(500, '1');
+
+    // nearly the largest accepted command line, 255 tokens, options given up to 64 times
+    std::string at_limit("job");
+    for (auto t = 0u; t < lim.max_list_elements; t++) {
+        at_limit.append(std::string("\0--name\0", 8)).append(long_tok);
+        if (t) {
+            at_limit.append(std::string("\0-n\0", 4)).append(long_tok);
+        }
+    }
+    at_limit.append(std::string("\0pos", 4));
+
+    struct {
+        const char* name;
+        std::string buf;
+    } corpus[] = {
+        {"at limit", at_limit},
+        {"1M flags", std::string("job\0", 4) + [&] { std::string s; for (auto i = 0; i < 1 << 20; i++) s += flag; return s; }()},
+        {"1M token", std::string("job\0--name\0", 11) + std::string(1 << 20, 'x')},
+        {"16k tokens", std::string("job") + [&] { std::string s; for (auto i = 0; i < 1 << 14; i++) s += std::string("\0-v", 3); return s; }()},
+    };
+
+    args.reset();
+    args.load_cmdline(at_limit.data(), at_limit.size());
+
+    const auto base = load_time(args, corpus[0].buf);
+    for (auto&& C : corpus) {
+        const auto t = load_time(args, C.buf);
+        std::cout << C.name << ": " << C.buf.size() << " bytes, " << t << " us" << std::endl;
+        if (t > 2 * base + 50) {
+            ok = false;
+            std::cerr << "Load time of " << C.name << " is not bounded." << std::endl;
+        }
+    }
+
+    std::cout << loaded << " of 100000 random command lines loaded" << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv)
+{
+    ArgumentParser args("Unit test for option value constraints.");
+
+    args.register_option({"r", "region"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    args.register_option({"n", "count"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+    args.register_option({"x", "mask"}, ArgumentOption::OPTIONAL, ArgumentType::HEX, "");
+    args.register_option({"f", "ratio"}, ArgumentOption::OPTIONAL, ArgumentType::FLT, "");
+    args.register_option({"u", "user"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    args.register_option({"b", "flag"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+
+    // large choice set, registered in reverse order
+    std::vector<std::string> regions;
+    for (auto i = 5000; i > 0; i--) {
+        regions.emplace_back("region-" + std::to_string(i));
+    }
+
+    bool ok = args.add_choices("region", regions)
+              && args.add_range("count", 1, 100)
+              && args.add_range("x", 0, 0xFF)
+              && args.add_range("ratio", 0.0, 1.0)
+              && args.add_pattern("user", ArgumentPattern::IDENTIFIER);
+
+    // constraints cannot be attached to unknown or BOOL options
+    ok = ok
+         && !args.add_choices("flag", {"yes"})
+         && !args.add_range("non-existent", 0, 1)
+         && !args.add_range("region", 0, 1)
+         && !args.add_range("count", 2, 1);
+
+    if (!ok) {
+        std::cerr << "Constraints were not registered as expected." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        args.load_arguments(argc, argv);
+    } catch (std::logic_error& ex) {
+        std::cerr << ex.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
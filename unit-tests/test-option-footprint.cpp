@@ -0,0 +1,48 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv)
+{
+    const auto count = 1000u;
+
+    ArgumentParser args;
+
+    for (auto i = 0u; i < count; i++) {
+        args.register_option({"o" + std::to_string(i), "option-number-" + std::to_string(i)},
+                             ArgumentOption::OPTIONAL,
+                             ArgumentType::INT,
+                             "Description of the option that is long enough to be stored on heap.");
+    }
+
+    args.load_arguments(argc, argv);
+
+    bool ok(true);
+
+    // every option is reachable by both names after the storage was grown
+    for (auto i = 0u; i < count; i++) {
+        if (!args.has_option("o" + std::to_string(i)) || !args.has_option("option-number-" + std::to_string(i))) {
+            ok = false;
+            std::cerr << "Option " << i << " cannot be found." << std::endl;
+        }
+    }
+
+    if (args.parse_option<int>("option-number-7") != 7) {
+        ok = false;
+        std::cerr << "Option value was not stored." << std::endl;
+    }
+
+    const auto fp = args.footprint();
+
+    std::cout << "options:           " << fp.options << std::endl;
+    std::cout << "hot bytes/option:  " << fp.hot_bytes / fp.options << std::endl;
+    std::cout << "cold bytes/option: " << fp.cold_bytes / fp.options << std::endl;
+    std::cout << "bytes/option:      " << fp.bytes_per_option() << std::endl;
+
+    // hot data is a value, a type, a flag and a constraint index per option (allowing for vector growth)
+    if (fp.hot_bytes / fp.options > 2 * (sizeof(std::string) + sizeof(ArgumentType) + 1 + sizeof(std::uint32_t))) {
+        ok = false;
+        std::cerr << "Hot option data is unexpectedly large." << std::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv)
+{
+    ArgumentParser args("Unit test for option handles.");
+
+    const auto threads = args.register_option({"t", "threads"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+    const auto ratio = args.register_option({"", "ratio"}, ArgumentOption::OPTIONAL, ArgumentType::FLT, "",
+                                            "", arg_default("0.5"));
+    const auto mode = args.register_option({"m", "mode"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    const auto dry = args.register_option({"n", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    const auto taken = args.register_option({"", "mode"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+
+    bool ok = true;
+
+    // handles are dense ids after the help option
+    if (!threads || threads.index != 1 || threads.type != ArgumentType::INT || ratio.index != 2
+        || mode.type != ArgumentType::STR || dry.index != 4 || taken || taken.valid())
+    {
+        ok = false;
+        std::cerr << "Unexpected option handles." << std::endl;
+    }
+
+    args.load_arguments(argc, argv);
+
+    if (args.parse_option<int>(threads) != args.parse_option<int>("threads") || args[mode] != args["mode"]
+        || args.option_is_set(dry) != args.option_is_set("n") || !args.option_is_set(ratio)
+        || args.parse_option<int>(taken) != 0)
+    {
+        ok = false;
+        std::cerr << "Handle accessors differ from name accessors." << std::endl;
+    }
+
+    // invalid handle reads as an unknown option
+    if (args.option_is_set(taken) || !args[taken].empty() || args.parse_option<int>(taken) != 0) {
+        ok = false;
+        std::cerr << "Invalid handle was read as an option." << std::endl;
+    }
+
+    // the snapshot shares option ids with the parser
+    const auto snap = args.freeze();
+
+    if (snap->get<int>(threads) != 8 || snap->get<double>(ratio) != 0.5 || (*snap)[mode] != "fast"
+        || !snap->option_is_set(dry) || snap->option_is_set(taken) || !(*snap)[taken].empty()
+        || snap->get<int>(taken) != 0)
+    {
+        ok = false;
+        std::cerr << "Handle accessors of the snapshot returned wrong values." << std::endl;
+    }
+
+    // hot loop reading tuning options
+    const auto loops = 10000000;
+    long sum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < loops; i++) {
+        sum += snap->get<int>(threads) + snap->option_is_set(dry);
+    }
+    const std::chrono::duration<double, std::nano> by_handle = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < loops / 10; i++) {
+        sum += snap->get<int>("threads") + snap->option_is_set("n");
+    }
+    const std::chrono::duration<double, std::nano> by_name = std::chrono::steady_clock::now() - start;
+
+    std::cout << "By handle: " << by_handle.count() / loops << " ns, by name: " << by_name.count() / (loops / 10)
+              << " ns per read (" << sum << ")" << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+static std::shared_ptr<const arg_option_set> common_options()
+{
+    auto common = std::make_shared<arg_option_set>();
+
+    common->register_option({"", "log-level"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "Logging level", arg_default("1"));
+    common->register_option({"", "trace"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "Enable tracing");
+    common->register_option({"", "token"}, ArgumentOption::REQUIRED, ArgumentType::STR, "Authentication token");
+
+    for (auto i = 0; i < 150; i++) {
+        common->register_option({"", "common-" + std::to_string(i)}, ArgumentOption::OPTIONAL, ArgumentType::STR, "Common option");
+    }
+
+    return common;
+}
+
+static bool loads(ArgumentParser args, std::vector<std::string> tokens)
+{
+    std::vector<char*> argv;
+    for (auto&& T : tokens) {
+        argv.push_back(&T[0]);
+    }
+
+    try {
+        args.load_arguments(static_cast<int>(argv.size()), argv.data());
+    } catch (std::logic_error&) {
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const auto common = common_options();
+
+    ArgumentParser tool("Tool using common options.");
+    ArgumentParser other("Another tool using common options.");
+
+    tool.add_mutually_exclusive_group("mode", false);
+    tool.register_option({"x", "extract"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "", "mode");
+    tool.add_parent(common);
+    tool.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+
+    other.add_parent(common);
+
+    bool ok(true);
+
+    // names of attached sets are taken
+    if (tool.register_option({"", "trace"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "")
+        || !tool.insert_into_group("mode", {"", "trace"}))
+    {
+        ok = false;
+        std::cerr << "Attached options are not visible to registration." << std::endl;
+    }
+
+    // both parsers share the set instead of copying it
+    if (common.use_count() != 3 || tool.footprint().shared_bytes != other.footprint().shared_bytes) {
+        ok = false;
+        std::cerr << "Option set is not shared." << std::endl;
+    }
+
+    // parent requirements and groups with attached options are validated
+    if (loads(tool, {"prog", "--log-level", "2"})
+        || loads(tool, {"prog", "--token", "t", "-x", "--trace"})
+        || !loads(tool, {"prog", "--token", "t", "--trace"}))
+    {
+        ok = false;
+        std::cerr << "Attached options are not validated." << std::endl;
+    }
+
+    // required option shadowed by an earlier one of the same name is not enforced
+    auto strict = std::make_shared<arg_option_set>();
+    strict->register_option({"", "name"}, ArgumentOption::REQUIRED, ArgumentType::STR, "Job name");
+
+    ArgumentParser shadowing("Tool with its own name option.");
+    shadowing.register_option({"", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    shadowing.add_parent(strict);
+
+    if (!loads(shadowing, {"prog"}) || !loads(shadowing, {"prog", "--name", "job"})) {
+        ok = false;
+        std::cerr << "Shadowed option of an attached set is still required." << std::endl;
+    }
+
+    tool.load_arguments(argc, argv);
+
+    if (tool.parse_option<int>("log-level") != 3
+        || tool["token"] != "secret"
+        || !tool.option_is_set("v")
+        || tool["common-149"] != "last"
+        || other.parse_option<int>("log-level") != 1)
+    {
+        ok = false;
+        std::cerr << "Attached options were not loaded." << std::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+#include <iostream>
+#include <spawn.h>
+#include <sys/wait.h>
+#include "arg_alloc.hpp"
+#include "arg_parser.hpp"
+
+ARG_ALLOC_COUNTING_NEW
+
+// argument vector pointing to given strings
+static std::vector<char*> make_argv(std::vector<std::string>& tokens)
+{
+    std::vector<char*> argv;
+    for (auto&& T : tokens) {
+        argv.push_back(const_cast<char*>(T.c_str()));
+    }
+    return argv;
+}
+
+int main()
+{
+    ArgumentParser args("Unit test for forwarding of unknown arguments.");
+
+    args.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"q", "quiet"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"l", "level"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+
+    std::vector<std::string> tokens{"wrapper", "-v", "--level", "3", "--child-opt=1", "-x", "-qz", "extra",
+                                    "--", "child", "-v", "--level", "9"};
+    auto argv = make_argv(tokens);
+
+    bool ok = true;
+
+    try {
+        args.load_arguments(static_cast<int>(argv.size()), argv.data());
+        ok = false;
+        std::cerr << "Unknown option was accepted without pass-through." << std::endl;
+    } catch (ArgumentError& ex) {
+        ok &= ex.code() == ArgumentErrorCode::UNKNOWN_OPTION;
+    }
+
+    args.set_pass_through(true);
+    args.reset();
+    args.load_arguments(static_cast<int>(argv.size()), argv.data());
+
+    const std::vector<std::size_t> expected{4, 5, 6, 7, 9, 10, 11, 12};
+
+    if (!args.option_is_set("v") || args.option_is_set("q") || args.parse_option<int>("level") != 3
+        || args.forwarded() != expected)
+    {
+        ok = false;
+        std::cerr << "Unexpected forwarded arguments." << std::endl;
+    }
+
+    // forwarded arguments are the original argv strings
+    auto fwd = args.forward_argv();
+    for (auto I = 0u; I < expected.size(); I++) {
+        if (fwd[I] != argv[expected[I]]) {
+            ok = false;
+            std::cerr << "Forwarded argument " << I << " was copied." << std::endl;
+        }
+    }
+    if (fwd[expected.size()] != nullptr) {
+        ok = false;
+        std::cerr << "Forwarded arguments are not null-terminated." << std::endl;
+    }
+
+    // unknown options after a positional argument are forwarded, known ones are still out of order
+    {
+        ArgumentParser ordered;
+        ordered.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+        ordered.register_positional(1);
+        ordered.set_pass_through(true);
+
+        std::vector<std::string> after{"wrapper", "input", "--child-flag", "-xy"};
+        auto after_argv = make_argv(after);
+        ordered.load_arguments(static_cast<int>(after_argv.size()), after_argv.data());
+
+        if (ordered[0] != "input" || ordered.forwarded() != std::vector<std::size_t>{2, 3}) {
+            ok = false;
+            std::cerr << "Unknown option after a positional argument was not forwarded." << std::endl;
+        }
+
+        std::vector<std::string> known{"wrapper", "input", "-v"};
+        auto known_argv = make_argv(known);
+        try {
+            ordered.reset();
+            ordered.load_arguments(static_cast<int>(known_argv.size()), known_argv.data());
+            ok = false;
+            std::cerr << "Known option after a positional argument was accepted." << std::endl;
+        } catch (ArgumentError& ex) {
+            ok &= ex.code() == ArgumentErrorCode::POSITIONAL_ORDER;
+        }
+    }
+
+    // forwarding many arguments allocates only the lists, loading again allocates nothing
+    std::vector<std::string> many{"wrapper", "-v"};
+    for (auto A = 0; A < 1000; A++) {
+        many.push_back("--child-option-number-" + std::to_string(A));
+    }
+    auto many_argv = make_argv(many);
+
+    {
+        arg_alloc_counter counter;
+        args.reset();
+        args.load_arguments(static_cast<int>(many_argv.size()), many_argv.data());
+        const auto first = counter.stats().allocations;
+
+        counter.restart();
+        args.reset();
+        args.load_arguments(static_cast<int>(many_argv.size()), many_argv.data());
+
+        std::cout << "Forwarding 1000 arguments: " << first << " allocations, again "
+                  << counter.stats().allocations << std::endl;
+
+        if (first > 2 || counter.stats().allocations != 0 || args.forwarded().size() != 1000) {
+            ok = false;
+            std::cerr << "Forwarding allocates per argument." << std::endl;
+        }
+    }
+
+    // forwarding from a command line buffer reserves the lists from a token count
+    std::string cmdline;
+    for (auto&& M : many) {
+        cmdline.append(M).push_back('\0');
+    }
+
+    {
+        ArgumentParser cmd;
+        cmd.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+        cmd.set_pass_through(true);
+
+        arg_alloc_counter counter;
+        cmd.load_cmdline(cmdline.data(), cmdline.size());
+
+        if (counter.stats().allocations > 2 || cmd.forwarded().size() != 1000) {
+            ok = false;
+            std::cerr << "Forwarding from a command line allocates per argument." << std::endl;
+        }
+
+        // the last token of an unterminated buffer would be forwarded without its NUL
+        try {
+            cmd.reset();
+            cmd.load_cmdline(cmdline.data(), cmdline.size() - 1);
+            ok = false;
+            std::cerr << "Unterminated command line was forwarded." << std::endl;
+        } catch (ArgumentError& ex) {
+            ok &= ex.code() == ArgumentErrorCode::INVALID_ARGUMENTS;
+        }
+    }
+
+    // forwarded arguments run the child
+    std::vector<std::string> launch{"wrapper", "-q", "--", "/bin/sh", "-c", "exit 7"};
+    auto launch_argv = make_argv(launch);
+
+    args.reset();
+    args.load_arguments(static_cast<int>(launch_argv.size()), launch_argv.data());
+
+    pid_t pid;
+    int status = 0;
+    if (posix_spawn(&pid, args.forward_argv()[0], nullptr, nullptr, args.forward_argv(), nullptr) != 0
+        || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 7)
+    {
+        ok = false;
+        std::cerr << "Child was not run with forwarded arguments." << std::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
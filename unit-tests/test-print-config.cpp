@@ -0,0 +1,59 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv)
+{
+    ArgumentParser args("Unit test for effective configuration dump.");
+
+    args.add_mutually_exclusive_group("mode", false);
+    args.register_option({"l", "level"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "", "", arg_default("1"));
+    args.register_option({"v", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "", "mode");
+    args.register_option({"", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    args.register_option({"", "unused"}, ArgumentOption::OPTIONAL, ArgumentType::FLT, "", "", arg_default("0.5"));
+    args.register_print_config_option();
+    args.register_positional(1);
+
+    args.load_arguments(argc, argv);
+
+    const std::string json =
+        "{\"exec\":\"test-print-config\",\"options\":["
+        "{\"short\":\"h\",\"long\":\"help\",\"type\":\"BOOL\",\"value\":\"\",\"source\":\"unset\",\"groups\":[]},"
+        "{\"short\":\"l\",\"long\":\"level\",\"type\":\"INT\",\"value\":\"3\",\"source\":\"set\",\"groups\":[]},"
+        "{\"short\":\"v\",\"long\":\"\",\"type\":\"BOOL\",\"value\":\"\",\"source\":\"set\",\"groups\":[\"mode\"]},"
+        "{\"short\":\"\",\"long\":\"name\",\"type\":\"STR\",\"value\":\"a\\\"b\\tc\",\"source\":\"set\",\"groups\":[]},"
+        "{\"short\":\"\",\"long\":\"unused\",\"type\":\"FLT\",\"value\":\"0.5\",\"source\":\"default\",\"groups\":[]},"
+        "{\"short\":\"\",\"long\":\"print-config\",\"type\":\"BOOL\",\"value\":\"\",\"source\":\"set\",\"groups\":[]}"
+        "],\"positional\":[\"pos\"]}\n";
+
+    const std::string kv =
+        "exec=test-print-config\n"
+        "--help=\ttype=BOOL\tsource=unset\tgroups=\n"
+        "--level=3\ttype=INT\tsource=set\tgroups=\n"
+        "-v=\ttype=BOOL\tsource=set\tgroups=mode\n"
+        "--name=a\"b\\tc\ttype=STR\tsource=set\tgroups=\n"
+        "--unused=0.5\ttype=FLT\tsource=default\tgroups=\n"
+        "--print-config=\ttype=BOOL\tsource=set\tgroups=\n"
+        "#0=pos\n";
+
+    bool ok = args.option_is_set("print-config");
+
+    if (args.dump_config(ConfigFormat::JSON) != json) {
+        ok = false;
+        std::cerr << "Unexpected JSON configuration:" << std::endl << args.dump_config(ConfigFormat::JSON);
+    }
+
+    if (args.dump_config(ConfigFormat::KEY_VALUE) != kv) {
+        ok = false;
+        std::cerr << "Unexpected key=value configuration:" << std::endl << args.dump_config(ConfigFormat::KEY_VALUE);
+    }
+
+    // output is built in a buffer of exact size
+    if (args.dump_config().capacity() < json.size() || args.dump_config().capacity() > json.size() + 15) {
+        ok = false;
+        std::cerr << "Configuration buffer was not pre-sized." << std::endl;
+    }
+
+    args.print_config(ConfigFormat::KEY_VALUE);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
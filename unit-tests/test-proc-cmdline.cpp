@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "arg_proc.hpp"
+
+// string literal including embedded NULs
+template<std::size_t N> static std::string nul_str(const char (&str)[N])
+{
+    return std::string(str, N - 1);
+}
+
+static void write_cmdline(const std::string& root, const std::string& pid, const std::string& cmdline)
+{
+    mkdir((root + "/" + pid).c_str(), 0700);
+    std::ofstream((root + "/" + pid + "/cmdline"), std::ios::binary) << cmdline;
+}
+
+int main()
+{
+    ArgumentParser schema("Unit test for command lines of running processes.");
+
+    schema.register_option({"p", "port"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "", "", arg_default("80"));
+    schema.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    schema.register_option({"", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+
+    ArgumentParser args(schema);
+    args.register_positional(1);
+
+    bool ok = true;
+
+    // buffer with the layout of /proc/<pid>/cmdline, including an empty argument
+    const auto cmdline(nul_str("/usr/bin/daemon\0--port=8080\0-v\0--name\0\0conf\0"));
+    args.load_cmdline(cmdline.data(), cmdline.size());
+
+    if (args.exec_name() != "daemon" || args.parse_option<int>("port") != 8080 || !args.option_is_set("v")
+        || !args.option_is_set("name") || args["name"] != "" || args[0] != "conf")
+    {
+        ok = false;
+        std::cerr << "Command line buffer was not loaded." << std::endl;
+    }
+
+    // buffer without the terminating NUL, previous values are cleared by reset
+    const std::string truncated(nul_str("daemon\0pos"));
+    args.reset();
+    args.load_cmdline(truncated.data(), truncated.size());
+
+    if (args.parse_option<int>("port") != 80 || args.option_is_set("v") || args[0] != "pos") {
+        ok = false;
+        std::cerr << "Parser was not reset before loading another command line." << std::endl;
+    }
+
+    // fake process table
+    char root_tmpl[] = "/tmp/test-proc-cmdline-XXXXXX";
+    const std::string root = mkdtemp(root_tmpl);
+
+    write_cmdline(root, "1", nul_str("/sbin/init\0"));
+    write_cmdline(root, "2", "");
+    write_cmdline(root, "10", nul_str("/opt/daemon\0-p\0" "443\0"));
+    write_cmdline(root, "11", nul_str("./daemon\0--unknown\0"));
+    write_cmdline(root, "self", nul_str("daemon\0"));
+
+    std::map<int, std::string> found;
+
+    ProcessScanner scanner(schema, root);
+    auto count = scanner.scan([&](int pid, const ArgumentParser& A, const std::string& error) {
+        found[pid] = error.empty() ? A.exec_name() + ":" + A["port"] : "error";
+    });
+
+    if (count != 3 || found.size() != 3 || found[1] != "init:80" || found[10] != "daemon:443" || found[11] != "error") {
+        ok = false;
+        std::cerr << "Unexpected processes in the fake process table." << std::endl;
+    }
+
+    found.clear();
+    scanner.filter_exec("daemon");
+    count = scanner.scan([&](int pid, const ArgumentParser&, const std::string&) { found[pid]; });
+
+    if (count != 2 || found.count(1)) {
+        ok = false;
+        std::cerr << "Executable filter was not applied." << std::endl;
+    }
+
+    for (auto pid : {"1", "2", "10", "11", "self"}) {
+        std::remove((root + "/" + pid + "/cmdline").c_str());
+        rmdir((root + "/" + pid).c_str());
+    }
+    rmdir(root.c_str());
+
+    // the real process table, most processes fail to match the schema
+    ProcessScanner live(schema);
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t failed = 0;
+    count = live.scan([&](int, const ArgumentParser&, const std::string& error) { failed += !error.empty(); });
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Scanned " << count << " processes (" << failed << " not matching) in "
+              << elapsed.count() * 1e3 << " ms, " << count / elapsed.count() << " processes/s" << std::endl;
+
+#if defined(__linux__)
+    if (count == 0) {
+        ok = false;
+        std::cerr << "No process found in /proc." << std::endl;
+    }
+#endif
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <dlfcn.h>
+#include <pthread.h>
+#include "arg_reload.hpp"
+
+// mutex locks taken by a thread while counting, pthread_mutex_lock is interposed for the whole program
+static thread_local bool counting = false;
+static thread_local std::size_t locks = 0;
+
+#if defined(__GLIBC__)
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    using lock_fn = int (*)(pthread_mutex_t*);
+    static std::atomic<lock_fn> real(nullptr);
+
+    if (counting) {
+        locks++;
+    }
+    if (!real) {
+        real = reinterpret_cast<lock_fn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    }
+    return real.load()(mutex);
+}
+#endif
+
+int main(int, char**)
+{
+    ArgumentParser proto("Unit test for reloadable arguments.");
+
+    proto.register_option({"l", "low"}, ArgumentOption::REQUIRED, ArgumentType::INT, "");
+    proto.register_option({"g", "high"}, ArgumentOption::REQUIRED, ArgumentType::INT, "");
+    proto.register_option({"v", "verbose"}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+
+    // every valid generation has high == low + 1, readers check the pair is never torn
+    std::vector<std::vector<std::string>> sources;
+    for (auto i = 0; i < 200; i++) {
+        sources.push_back({"prog", "-l", std::to_string(i), "-g", std::to_string(i + 1)});
+    }
+    auto next = 0u;
+
+    ArgumentReloader reloader(proto, [&sources, &next]() { return sources[next]; });
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> torn(false);
+    std::vector<std::thread> readers;
+
+    for (auto t = 0; t < 4; t++) {
+        readers.emplace_back([&reloader, &stop, &torn]()
+        {
+            while (!stop) {
+                const auto S = reloader.current();
+                if (S->get<int>("high") != S->get<int>("low") + 1) {
+                    torn = true;
+                }
+            }
+        });
+    }
+
+    bool ok(true);
+
+    for (next = 1; next < sources.size(); next++) {
+        const auto res = reloader.reload();
+        if (!res.accepted || res.changes.size() != 2) {
+            ok = false;
+            std::cerr << "Valid reload " << next << " was not published as expected." << std::endl;
+        }
+    }
+
+    // missing mandatory option is rejected and the previous snapshot stays published
+    sources.push_back({"prog", "-l", "1000", "-v"});
+    const auto res = reloader.reload();
+
+    stop = true;
+    for (auto&& T : readers) {
+        T.join();
+    }
+
+    if (res.accepted || res.error.empty() || res.changes.size() != 3) {
+        ok = false;
+        std::cerr << "Invalid reload was not rejected as expected." << std::endl;
+    }
+    for (auto&& C : res.changes) {
+        std::cout << C.name << ": '" << C.old_value << "' -> '" << C.new_value << "'" << std::endl;
+    }
+
+    // snapshot held by a reader outlives the reload that replaces it
+    const auto held = reloader.current();
+    if (held->get<int>("low") != 199 || held->option_is_set("verbose")) {
+        ok = false;
+        std::cerr << "Rejected reload replaced the published snapshot." << std::endl;
+    }
+
+    if (torn) {
+        ok = false;
+        std::cerr << "Reader observed a half-updated snapshot." << std::endl;
+    }
+
+    sources.push_back({"prog", "-l", "1000", "-g", "1001"});
+    next++;
+    if (!reloader.reload().accepted || reloader.current()->get<int>("low") != 1000 || held->get<int>("low") != 199) {
+        ok = false;
+        std::cerr << "Held snapshot changed after a reload." << std::endl;
+    }
+
+    // reading takes no lock, not even while a reload is in progress
+    std::atomic<bool> stall(false);
+    std::atomic<bool> stalled(false);
+    std::atomic<bool> resume(false);
+
+    ArgumentReloader slow(proto, [&stall, &stalled, &resume]()
+    {
+        if (stall) {
+            stalled = true;
+            while (!resume) {
+                std::this_thread::yield();
+            }
+        }
+        return std::vector<std::string>{"prog", "-l", "1", "-g", "2"};
+    });
+
+    const auto first = slow.current();
+    stall = true;
+    std::thread writer([&slow]() { slow.reload(); });
+    while (!stalled) {
+        std::this_thread::yield();
+    }
+
+    std::mutex probe;
+    counting = true;
+    { std::lock_guard<std::mutex> lock(probe); }
+    const auto probe_locks = locks;
+
+    locks = 0;
+    auto same = true;
+    for (auto R = 0; R < 100000; R++) {
+        same = same && slow.current() == first;
+    }
+    const auto read_locks = locks;
+    counting = false;
+
+    resume = true;
+    writer.join();
+
+    if (probe_locks != 1) {
+        std::cout << "Mutex locks cannot be counted, lock-free reading not checked." << std::endl;
+    } else if (read_locks != 0 || !same) {
+        ok = false;
+        std::cerr << "Reading the published snapshot took " << read_locks << " locks." << std::endl;
+    }
+    if (slow.current() == first) {
+        ok = false;
+        std::cerr << "Reader did not get the snapshot of a finished reload." << std::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
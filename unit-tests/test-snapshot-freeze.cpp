@@ -0,0 +1,96 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include "arg_parser.hpp"
+
+int main(int argc, char** argv)
+{
+    std::shared_ptr<const ArgumentSnapshot> snap;
+
+    {
+        ArgumentParser args;
+
+        args.register_option({"", "int"}, ArgumentOption::REQUIRED, ArgumentType::INT, "");
+        args.register_option({"", "hex"}, ArgumentOption::REQUIRED, ArgumentType::HEX, "");
+        args.register_option({"", "string"}, ArgumentOption::REQUIRED, ArgumentType::STR, "");
+        args.register_option({"", "float"}, ArgumentOption::REQUIRED, ArgumentType::FLT, "");
+        args.register_option({"b", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+        args.register_positional(1);
+
+        args.load_arguments(argc, argv);
+
+        snap = args.freeze();
+    }
+
+    // snapshot outlives the parser
+    const auto& S = *snap;
+    const auto int_id = S.index("int");
+
+    std::atomic<bool> ok(int_id != ArgumentSnapshot::npos);
+    std::vector<std::thread> readers;
+
+    for (auto t = 0; t < 8; t++) {
+        readers.emplace_back([&S, &ok, int_id]()
+        {
+            for (auto i = 0; i < 100000; i++) {
+                const bool good = S.get<int>(int_id) == 1
+                                  && S.get<long>("hex") == 0xFF
+                                  && S["string"] == "Hello"
+                                  && std::abs(S.get<float>("float") - 0.1f) < 0.0001
+                                  && !S.option_is_set("b")
+                                  && !S.get<bool>("b")
+                                  && S.get<int>("non-existent") == 0
+                                  && S[0] == "pos";
+                if (!good) {
+                    ok = false;
+                    break;
+                }
+            }
+        });
+    }
+
+    for (auto&& T : readers) {
+        T.join();
+    }
+
+    if (!ok) {
+        std::cerr << "Snapshot returned unexpected values." << std::endl;
+    }
+
+    // misspelled name gives npos, reading by it is a miss rather than out of bounds
+    const auto miss = S.index("nonexistent");
+    if (S.option_is_set(miss) || S.get<int>(miss) != 0 || !S.value(miss).empty()) {
+        ok = false;
+        std::cerr << "Unknown index read option data." << std::endl;
+    }
+
+    // integral reads of huge and non-finite FLT values saturate
+    const struct {
+        const char* value;
+        long long expect;
+    } floats[] = {
+        {"1e300", std::numeric_limits<long long>::max()},
+        {"-1e300", std::numeric_limits<long long>::min()},
+        {"inf", std::numeric_limits<long long>::max()},
+        {"nan", 0},
+        {"-2.5", -2},
+    };
+
+    for (auto&& F : floats) {
+        ArgumentParser args;
+        args.register_option({"f", ""}, ArgumentOption::OPTIONAL, ArgumentType::FLT, "");
+
+        std::vector<std::string> tokens{"prog", "-f", F.value};
+        std::vector<char*> fargv{&tokens[0][0], &tokens[1][0], &tokens[2][0]};
+        args.load_arguments(static_cast<int>(fargv.size()), fargv.data());
+
+        if (args.freeze()->get<long long>("f") != F.expect) {
+            ok = false;
+            std::cerr << "FLT value " << F.value << " was not truncated as expected." << std::endl;
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+#include "arg_parser.hpp"
+
+static void register_options(ArgumentParser& args)
+{
+    args.register_option({"", "int"}, ArgumentOption::REQUIRED, ArgumentType::INT, "");
+    args.register_option({"s", "string"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "", "", arg_default("default"));
+    args.register_option({"b", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"u", "unset"}, ArgumentOption::OPTIONAL, ArgumentType::FLT, "");
+    args.register_positional(2);
+}
+
+static bool same_state(ArgumentParser& expect, ArgumentParser& got)
+{
+    bool ok = expect.exec_name() == got.exec_name();
+
+    for (auto&& key : {"int", "string", "b", "unset", "help"}) {
+        ok = ok && expect[key] == got[key] && expect.option_is_set(key) == got.option_is_set(key);
+    }
+
+    // source of every option (given, default, unset) survives
+    return ok && expect[0] == got[0] && expect[1] == got[1]
+           && expect.dump_config(ConfigFormat::KEY_VALUE) == got.dump_config(ConfigFormat::KEY_VALUE);
+}
+
+int main(int argc, char** argv)
+{
+    ArgumentParser parent;
+    register_options(parent);
+    parent.load_arguments(argc, argv);
+
+    const auto blob = parent.serialize();
+
+    bool ok(true);
+
+    // child without any registration
+    ArgumentParser bare;
+    bare.deserialize(blob);
+    if (!same_state(parent, bare) || bare.parse_option<int>("int") != parent.parse_option<int>("int")) {
+        ok = false;
+        std::cerr << "State restored into an empty parser differs." << std::endl;
+    }
+
+    // child with the same registration
+    ArgumentParser child;
+    register_options(child);
+    child.deserialize(blob);
+    if (!same_state(parent, child)) {
+        ok = false;
+        std::cerr << "State restored into a registered parser differs." << std::endl;
+    }
+
+    // registered option of another type does not take the stored value
+    try {
+        ArgumentParser other;
+        other.register_option({"", "int"}, ArgumentOption::REQUIRED, ArgumentType::STR, "");
+        other.deserialize(blob);
+        ok = false;
+        std::cerr << "Snapshot was loaded into an option of another type." << std::endl;
+    } catch (std::logic_error&) {
+    }
+
+    // flag byte of the first option record
+    auto bad_flag = blob;
+    bad_flag[4 + 2 + 2 + 4 + 4 + 4 + parent.exec_name().size() + 1] = 7;
+
+    // positional count larger than the data is rejected before anything is allocated
+    auto bad_count = blob;
+    const std::uint32_t huge = 0x7fffffff;
+    bad_count.replace(4 + 2 + 2 + 4, sizeof(huge), reinterpret_cast<const char*>(&huge), sizeof(huge));
+
+    // truncated and foreign data is rejected
+    for (auto&& bad : {blob.substr(0, blob.size() - 1), std::string("XXXX") + blob.substr(4), bad_flag, bad_count}) {
+        try {
+            ArgumentParser reject;
+            reject.deserialize(bad);
+            ok = false;
+            std::cerr << "Malformed snapshot was accepted." << std::endl;
+        } catch (std::logic_error&) {
+        }
+    }
+
+    // rejected snapshot leaves the parser untouched
+    ArgumentParser intact;
+    register_options(intact);
+    try {
+        intact.deserialize(blob.substr(0, blob.size() - 1));
+    } catch (std::logic_error&) {
+    }
+    if (!intact.exec_name().empty() || intact.option_is_set("int") || intact["string"] != "default") {
+        ok = false;
+        std::cerr << "Rejected snapshot was partially applied." << std::endl;
+    }
+
+    std::cout << "snapshot size: " << blob.size() << " bytes" << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
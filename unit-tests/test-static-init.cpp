@@ -0,0 +1,69 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <elf.h>
+
+// size of the .init_array section of an ELF file, npos if the file cannot be read
+template<typename Ehdr, typename Shdr> static std::size_t init_array_size(const std::string& elf)
+{
+    Ehdr eh;
+    if (elf.size() < sizeof(eh)) {
+        return std::string::npos;
+    }
+    std::memcpy(&eh, elf.data(), sizeof(eh));
+
+    if (eh.e_shoff + static_cast<std::size_t>(eh.e_shnum) * sizeof(Shdr) > elf.size() || eh.e_shstrndx >= eh.e_shnum) {
+        return std::string::npos;
+    }
+
+    Shdr names;
+    std::memcpy(&names, elf.data() + eh.e_shoff + eh.e_shstrndx * sizeof(Shdr), sizeof(names));
+
+    for (auto S = 0u; S < eh.e_shnum; S++) {
+        Shdr sh;
+        std::memcpy(&sh, elf.data() + eh.e_shoff + S * sizeof(Shdr), sizeof(sh));
+
+        const auto name = names.sh_offset + sh.sh_name;
+        if (name < elf.size() && std::strcmp(elf.c_str() + name, ".init_array") == 0) {
+            return sh.sh_size;
+        }
+    }
+
+    return 0;
+}
+
+static std::size_t init_array_size(const char* path)
+{
+    std::ifstream in(path, std::ios::binary);
+    const std::string elf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (elf.size() < EI_NIDENT || std::memcmp(elf.data(), ELFMAG, SELFMAG) != 0) {
+        return std::string::npos;
+    }
+
+    return elf[EI_CLASS] == ELFCLASS64 ? init_array_size<Elf64_Ehdr, Elf64_Shdr>(elf)
+                                       : init_array_size<Elf32_Ehdr, Elf32_Shdr>(elf);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " LIBRARY REFERENCE" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto lib = init_array_size(argv[1]);
+    const auto ref = init_array_size(argv[2]);
+
+    std::cout << argv[1] << ": .init_array " << lib << " bytes, empty library " << ref << " bytes" << std::endl;
+
+    // anything beyond the toolchain entries is a static initializer run when the library is loaded
+    if (lib == std::string::npos || ref == std::string::npos || lib > ref) {
+        std::cerr << "Shared library runs static initializers." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "arg_parser.hpp"
+
+static void register_options(ArgumentParser& args)
+{
+    args.register_option({"a", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"b", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"c", ""}, ArgumentOption::OPTIONAL, ArgumentType::BOOL, "");
+    args.register_option({"", "int"}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+    args.register_option({"k", ""}, ArgumentOption::OPTIONAL, ArgumentType::INT, "");
+    args.register_option({"", "float"}, ArgumentOption::OPTIONAL, ArgumentType::FLT, "");
+    args.register_option({"x", ""}, ArgumentOption::OPTIONAL, ArgumentType::HEX, "");
+    args.register_option({"", "name"}, ArgumentOption::OPTIONAL, ArgumentType::STR, "");
+    args.register_positional(1);
+}
+
+int main(int argc, char** argv)
+{
+    bool ok(true);
+
+    // forms given on the command line
+    {
+        ArgumentParser args;
+        register_options(args);
+
+        try {
+            args.load_arguments(argc, argv);
+        } catch (std::logic_error& ex) {
+            std::cerr << ex.what() << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        ok = args.option_is_set("a") && args.option_is_set("b") && args.option_is_set("c")
+             && args.parse_option<int>("int") == -5
+             && args.parse_option<int>("k") == 7
+             && std::abs(args.parse_option<float>("float") + 0.5f) < 0.0001
+             && args.parse_option<int>("x") == -0xFF
+             && args["name"] == "a=b"
+             && args[0] == "-pos";
+
+        if (!ok) {
+            std::cerr << "Command line was not tokenized as expected." << std::endl;
+        }
+    }
+
+    // million-token fixture
+    const std::vector<std::string> pattern = {"-abc", "--int=-5", "-k7", "--float", "-0.5", "--name", "value", "-x", "1F"};
+    const auto count = 1000000u;
+
+    std::vector<std::string> tokens{"prog"};
+    tokens.reserve(count + 3);
+    while (tokens.size() <= count) {
+        tokens.push_back(pattern[tokens.size() % pattern.size()]);
+    }
+    tokens.push_back("--");
+    tokens.push_back("-last");
+
+    std::vector<char*> fixture;
+    for (auto&& T : tokens) {
+        fixture.push_back(&T[0]);
+    }
+
+    ArgumentParser args;
+    register_options(args);
+
+    const auto start = std::chrono::steady_clock::now();
+    args.load_arguments(static_cast<int>(fixture.size()), fixture.data());
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (args[0] != "-last" || args.parse_option<int>("k") != 7 || args["name"] != "value") {
+        ok = false;
+        std::cerr << "Million-token fixture was not tokenized as expected." << std::endl;
+    }
+
+    std::cout << fixture.size() - 1 << " tokens in " << elapsed * 1000 << " ms ("
+              << (fixture.size() - 1) / elapsed / 1e6 << " M tokens/s)" << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}